@@ -0,0 +1,205 @@
+/*
+ *     IKChain.h
+ *
+ *     This file implements a planar linkage model that caches each joint's
+ *     contribution to the end effector position, so the descent solver can
+ *     evaluate a single joint perturbation without redoing the others.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_CHAIN_H_
+#define _IK_CHAIN_H_
+
+#include "IKSolve.h"
+#include "VectorLib/Vector.h"
+
+#include <cmath>
+
+enum IKChainType
+{
+    // Each joint sets its link's direction directly, as in a parallel
+    // linkage: link k points at angles[k] + phases[k]
+    IK_CHAIN_ABSOLUTE,
+    // Each joint turns everything after it, as in an arm: link k points at
+    // the sum of angles[0..k] + phases[0..k]
+    IK_CHAIN_SERIAL
+};
+
+// One joint's cached state, kept together so a perturbation touches a single
+// cache line
+struct IKChainJoint
+{
+    float length;
+    float phase;
+    float angle;
+    // Direction of the joint's link
+    float c, s;
+    // Where the link starts (IK_CHAIN_SERIAL only)
+    float x, y;
+};
+
+// End effector position of an N joint planar linkage. Besides being a plain
+// forward kinematics callable, it can be passed to solve<N>() directly, which
+// then evaluates each trial step with one sin/cos pair whatever N is:
+//
+//   IKChain<2> leg(radii, phases, Vector2d(offsets[0], offsets[1]));
+//   solve<2>(angles, ranges, radii, leg, target, 1.0f);
+//
+// Accepted steps update the cached terms incrementally, which lets rounding
+// accumulate over a solve; each solve starts from a full recompute.
+template<int N>
+class IKChain
+{
+public:
+    IKChain(const float* lengths, const float* phases, const Vector2d& base, IKChainType type = IK_CHAIN_ABSOLUTE) :
+        chainType(type),
+        origin(base)
+    {
+        for(int k = 0; k < N; k++)
+        {
+            joints[k].length = lengths[k];
+            joints[k].phase = phases[k];
+            joints[k].angle = 0.0f;
+        }
+        float zero[N] = {0.0f};
+        setAngles(zero);
+    }
+
+    // Recomputes every term for a new pose
+    void setAngles(const float* angles)
+    {
+        float direction = 0.0f;
+        float x = origin.x, y = origin.y;
+        for(int k = 0; k < N; k++)
+        {
+            IKChainJoint& joint = joints[k];
+            joint.angle = angles[k];
+            direction = (chainType == IK_CHAIN_SERIAL) ? (direction + angles[k] + joint.phase) : (angles[k] + joint.phase);
+            joint.c = std::cos(direction);
+            joint.s = std::sin(direction);
+            joint.x = x;
+            joint.y = y;
+            x += joint.length*joint.c;
+            y += joint.length*joint.s;
+        }
+        end = Vector2d(x, y);
+    }
+
+    // End effector position for the cached pose
+    const Vector2d& position() const
+    {
+        return end;
+    }
+
+    // End effector position with joint k moved to angle, all others cached
+    Vector2d trial(int k, float angle) const
+    {
+        const IKChainJoint& joint = joints[k];
+        if(chainType == IK_CHAIN_SERIAL)
+        {
+            // Everything from joint k on turns about its pivot
+            const float d = angle - joint.angle;
+            const float c = std::cos(d), s = std::sin(d);
+            const float vx = end.x - joint.x, vy = end.y - joint.y;
+            return Vector2d(joint.x + c*vx - s*vy, joint.y + s*vx + c*vy);
+        }
+        const float c = std::cos(angle + joint.phase), s = std::sin(angle + joint.phase);
+        return Vector2d(end.x + joint.length*(c - joint.c), end.y + joint.length*(s - joint.s));
+    }
+
+    // Moves joint k to angle in the cache
+    void commit(int k, float angle)
+    {
+        IKChainJoint& joint = joints[k];
+        if(chainType == IK_CHAIN_SERIAL)
+        {
+            // Turn the links from k on, and move the pivots after k, without
+            // any further trig
+            const float d = angle - joint.angle;
+            const float c = std::cos(d), s = std::sin(d);
+            joint.angle = angle;
+            float x = joint.x, y = joint.y;
+            for(int m = k; m < N; m++)
+            {
+                IKChainJoint& link = joints[m];
+                const float lc = link.c*c - link.s*s;
+                link.s = link.s*c + link.c*s;
+                link.c = lc;
+                link.x = x;
+                link.y = y;
+                x += link.length*link.c;
+                y += link.length*link.s;
+            }
+            end = Vector2d(x, y);
+            return;
+        }
+        const float c = std::cos(angle + joint.phase), s = std::sin(angle + joint.phase);
+        end = Vector2d(end.x + joint.length*(c - joint.c), end.y + joint.length*(s - joint.s));
+        joint.angle = angle;
+        joint.c = c;
+        joint.s = s;
+    }
+
+    // Full forward solve of any pose; leaves the cache alone
+    Vector2d operator()(const float* angles) const
+    {
+        float direction = 0.0f;
+        float x = origin.x, y = origin.y;
+        for(int k = 0; k < N; k++)
+        {
+            direction = (chainType == IK_CHAIN_SERIAL) ? (direction + angles[k] + joints[k].phase) : (angles[k] + joints[k].phase);
+            x += joints[k].length*std::cos(direction);
+            y += joints[k].length*std::sin(direction);
+        }
+        return Vector2d(x, y);
+    }
+
+private:
+    IKChainType chainType;
+    Vector2d origin;
+    Vector2d end;
+    IKChainJoint joints[N];
+};
+
+// Descent hooks (see IKSolve.h): the solver keeps the cache in step with the
+// pose it is working on
+template<int N>
+inline void ikReset(IKChain<N>& chain, float* angles)
+{
+    chain.setAngles(angles);
+}
+
+template<int N>
+inline Vector2d ikCurrent(IKChain<N>& chain, float*)
+{
+    return chain.position();
+}
+
+template<int N>
+inline Vector2d ikTrial(IKChain<N>& chain, float* angles, int joint)
+{
+    return chain.trial(joint, angles[joint]);
+}
+
+template<int N>
+inline void ikAccept(IKChain<N>& chain, float* angles, int joint)
+{
+    chain.commit(joint, angles[joint]);
+}
+
+#endif // _IK_CHAIN_H_
@@ -0,0 +1,140 @@
+/*
+ *     IKConstexpr.h
+ *
+ *     This file implements the compile-time side of the solver: a position
+ *     type and helpers the shared solver code can be run on by the compiler,
+ *     so IK tables can be built at compile time.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_CONSTEXPR_H_
+#define _IK_CONSTEXPR_H_
+
+// Needs C++14 relaxed constexpr (loops and local state)
+#if __cplusplus >= 201402L
+#define IK_HAVE_CONSTEXPR 1
+
+#include "IKFastTrig.h"
+#include "IKSolveDLS.h"
+
+#include <stdint.h>
+
+// Constant-evaluable replacements for the <cmath> functions the solver needs
+// beyond ikSinCosC()
+constexpr float ikSqrtC(float x)
+{
+    if(x <= 0.0f)
+    {
+        return 0.0f;
+    }
+    // Newton's method from an estimate within a factor of two, which
+    // converges to float precision in a handful of steps
+    float r = 1.0f;
+    while(r*r < x)
+    {
+        r *= 2.0f;
+    }
+    while(r*r > 4.0f*x)
+    {
+        r *= 0.5f;
+    }
+    for(int k = 0; k < 6; k++)
+    {
+        r = 0.5f*(r + x/r);
+    }
+    return r;
+}
+
+// std::lround(): to the nearest integer, halfway cases away from zero. The
+// float is widened first, so adding the half can't round it up.
+constexpr long ikRoundC(float x)
+{
+    return (x < 0.0f) ? -(long)(0.5 - (double)x) : (long)((double)x + 0.5);
+}
+
+// Literal stand-in for Vector2d, with the part of its interface
+// solveDLSImpl() uses
+struct IKVec2C
+{
+    float x, y;
+
+    constexpr IKVec2C operator-(const IKVec2C& other) const
+    {
+        return IKVec2C{x - other.x, y - other.y};
+    }
+
+    constexpr float magnitude() const
+    {
+        return ikSqrtC(x*x + y*y);
+    }
+};
+
+template<int N>
+struct IKSolutionC
+{
+    float angles[N];
+    // solveDLS() result: forward solves spent, or -1
+    int result;
+};
+
+// solveDLS() at compile time: the same solveDLSImpl(), cold started from the
+// zero pose. FK is a literal type with a constexpr
+// IKVec2C operator()(const float* angles) const.
+template<int N, class FK>
+constexpr IKSolutionC<N> solveDLSConstexpr(const float (&ranges)[N][2], const FK& forwardSolve, IKVec2C target, float reqError)
+{
+    IKSolutionC<N> sol = {};
+    FK fk = forwardSolve;
+    IKFiniteDifferenceJacobian<N, FK> jacobian = {fk, ranges};
+    sol.result = solveDLSImpl<N>(sol.angles, ranges, fk, jacobian, target, reqError);
+    return sol;
+}
+
+// Table in the layout tester.cpp writes to LegLUT.c and IKLut reads:
+// data[j][i][k] is joint k of the target <xLower + i*xStep, yLower + j*yStep>,
+// in 1/scale radians rounded like lutQuantize(), or sentinel if unreachable
+template<int X, int Y, int N>
+struct IKTableC
+{
+    int16_t data[Y][X][N];
+    int solved;
+};
+
+template<int X, int Y, int N, class FK>
+constexpr IKTableC<X, Y, N> generateLUTConstexpr(float xLower, float yLower, float xStep, float yStep, const float (&ranges)[N][2], const FK& forwardSolve, float reqError, float scale, int16_t sentinel)
+{
+    IKTableC<X, Y, N> table = {};
+    for(int j = 0; j < Y; j++)
+    {
+        for(int i = 0; i < X; i++)
+        {
+            const IKVec2C target = {xLower + (i*xStep), yLower + (j*yStep)};
+            const IKSolutionC<N> sol = solveDLSConstexpr<N>(ranges, forwardSolve, target, reqError);
+            for(int k = 0; k < N; k++)
+            {
+                table.data[j][i][k] = (sol.result == -1) ? sentinel : (int16_t)ikRoundC(sol.angles[k]*scale);
+            }
+            table.solved += (sol.result == -1) ? 0 : 1;
+        }
+    }
+    return table;
+}
+
+#endif // __cplusplus >= 201402L
+
+#endif // _IK_CONSTEXPR_H_
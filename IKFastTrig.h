@@ -0,0 +1,173 @@
+/*
+ *     IKFastTrig.h
+ *
+ *     This file implements polynomial sine and cosine approximations for the
+ *     forward kinematics, in scalar and SIMD form.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_FAST_TRIG_H_
+#define _IK_FAST_TRIG_H_
+
+#include "IKSimd.h"
+
+#include <cmath>
+
+// The approximations skip range reduction altogether: they are only valid
+// for |angle| <= IK_FAST_TRIG_DOMAIN, which covers joints limited to +-90deg.
+// Measured against double precision libm over that domain (with float
+// evaluation), the maximum absolute error is IK_FAST_SIN_ERROR for sine and
+// IK_FAST_COS_ERROR for cosine; libm's own float error is about 3.3e-8.
+// Beyond the domain the error grows quickly, so the caller has to check its
+// joint ranges (see ikFastTrigCovers()).
+#define IK_FAST_TRIG_DOMAIN 1.5707963f
+#define IK_FAST_SIN_ERROR 7.4e-7f
+#define IK_FAST_COS_ERROR 1.7e-7f
+
+// Near-minimax fits over [-pi/2, pi/2]: sine odd to x^7, cosine even to x^8
+#define IK_FAST_SIN_C1 0.99999661587649f
+#define IK_FAST_SIN_C3 -0.16664828371631f
+#define IK_FAST_SIN_C5 0.0083063251437404f
+#define IK_FAST_SIN_C7 -0.00018363652041688f
+#define IK_FAST_COS_C0 0.99999995346537f
+#define IK_FAST_COS_C2 -0.49999905345518f
+#define IK_FAST_COS_C4 0.041663584662746f
+#define IK_FAST_COS_C6 -0.0013853704116172f
+#define IK_FAST_COS_C8 2.3153927833247e-05f
+
+// Marks code the compiler can run at compile time given C++14 relaxed
+// constexpr (loops and local state); plain inline code before that
+#if __cplusplus >= 201402L
+#define IK_CONSTEXPR14 constexpr
+#else
+#define IK_CONSTEXPR14 inline
+#endif
+
+// Which sine and cosine a forward kinematics function evaluates with
+enum IKPrecision
+{
+    // std::sin/std::cos, or the range-reduced ikSinCos() in SIMD code
+    IK_PRECISION_FLOAT,
+    // The polynomials below, within the documented error
+    IK_PRECISION_APPROX,
+    // ikSinCosC(), which the compiler can evaluate (from C++14), for
+    // tables built at compile time. SIMD code uses the float path instead.
+    IK_PRECISION_CONSTEXPR
+};
+
+// Taylor series on [-pi/2, pi/2] after range reduction, in double; both
+// from the one reduction, in Horner form, which keeps the compile-time table
+// within the compiler's constexpr operation limits. The series run to x^13
+// and x^12, so the truncation error (below 1e-8) is under float rounding.
+IK_CONSTEXPR14 void ikSinCosC(float x, float& s, float& c)
+{
+    const double twoPi = 6.283185307179586;
+    double d = x;
+    const long turns = (long)(d/twoPi + ((d >= 0.0) ? 0.5 : -0.5));
+    d -= turns*twoPi;
+    // Reflecting about +-pi/2 keeps the sine and negates the cosine
+    double cosSign = 1.0;
+    if(d > twoPi/4)
+    {
+        d = twoPi/2 - d;
+        cosSign = -1.0;
+    }
+    else if(d < -twoPi/4)
+    {
+        d = -twoPi/2 - d;
+        cosSign = -1.0;
+    }
+    const double d2 = d*d;
+    s = (float)(d*(1.0 - d2/6.0*(1.0 - d2/20.0*(1.0 - d2/42.0*(1.0 - d2/72.0*(1.0 - d2/110.0*(1.0 - d2/156.0)))))));
+    c = (float)(cosSign*(1.0 - d2/2.0*(1.0 - d2/12.0*(1.0 - d2/30.0*(1.0 - d2/56.0*(1.0 - d2/90.0*(1.0 - d2/132.0)))))));
+}
+
+inline float ikFastSin(float a)
+{
+    const float a2 = a*a;
+    return a*(IK_FAST_SIN_C1 + a2*(IK_FAST_SIN_C3 + a2*(IK_FAST_SIN_C5 + a2*IK_FAST_SIN_C7)));
+}
+
+inline float ikFastCos(float a)
+{
+    const float a2 = a*a;
+    return IK_FAST_COS_C0 + a2*(IK_FAST_COS_C2 + a2*(IK_FAST_COS_C4 + a2*(IK_FAST_COS_C6 + a2*IK_FAST_COS_C8)));
+}
+
+inline void ikFastSinCos(float a, float& s, float& c)
+{
+    s = ikFastSin(a);
+    c = ikFastCos(a);
+}
+
+// The same polynomials on IK_SIMD_WIDTH angles at once; cheaper than
+// ikSinCos(), which has to reduce the angle first
+inline void ikFastSinCos(const IKFloatV& a, IKFloatV& s, IKFloatV& c)
+{
+    const IKFloatV a2 = a*a;
+    s = a*(ikSet1(IK_FAST_SIN_C1) + a2*(ikSet1(IK_FAST_SIN_C3) + a2*(ikSet1(IK_FAST_SIN_C5) + a2*ikSet1(IK_FAST_SIN_C7))));
+    c = ikSet1(IK_FAST_COS_C0) + a2*(ikSet1(IK_FAST_COS_C2) + a2*(ikSet1(IK_FAST_COS_C4) + a2*(ikSet1(IK_FAST_COS_C6) + a2*ikSet1(IK_FAST_COS_C8))));
+}
+
+// Sine and cosine at the given precision; P is a compile-time constant, so
+// the branch folds away. Constant-evaluable with IK_PRECISION_CONSTEXPR.
+template<IKPrecision P>
+IK_CONSTEXPR14 void ikSinCos(float a, float& s, float& c)
+{
+    if(P == IK_PRECISION_APPROX)
+    {
+        ikFastSinCos(a, s, c);
+    }
+    else if(P == IK_PRECISION_CONSTEXPR)
+    {
+        ikSinCosC(a, s, c);
+    }
+    else
+    {
+        s = std::sin(a);
+        c = std::cos(a);
+    }
+}
+
+template<IKPrecision P>
+inline void ikSinCos(const IKFloatV& a, IKFloatV& s, IKFloatV& c)
+{
+    if(P == IK_PRECISION_APPROX)
+    {
+        ikFastSinCos(a, s, c);
+    }
+    else
+    {
+        ikSinCos(a, s, c);
+    }
+}
+
+// Whether every joint range lies inside IK_FAST_TRIG_DOMAIN
+inline bool ikFastTrigCovers(const float ranges[][2], int nJoints)
+{
+    for(int j = 0; j < nJoints; j++)
+    {
+        if(ranges[j][0] < -IK_FAST_TRIG_DOMAIN || ranges[j][1] > IK_FAST_TRIG_DOMAIN)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // _IK_FAST_TRIG_H_
@@ -0,0 +1,373 @@
+/*
+ *     IKLegScheduler.h
+ *
+ *     This file implements a scheduler that tracks targets for several legs
+ *     at once, one control tick at a time, on dedicated worker threads.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_LEG_SCHEDULER_H_
+#define _IK_LEG_SCHEDULER_H_
+
+#include "IKSolve.h"
+#include "IKTracker.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Size of a cache line, to keep data written by different threads apart
+#define IK_CACHE_LINE 64
+
+// Single writer, many reader snapshot. The writer never waits; a reader that
+// overlaps a write retries, so it always sees one complete value. The value
+// is kept as relaxed atomic words, so a read racing a write is well defined
+// (and then thrown away) rather than a data race. T must be trivially
+// copyable.
+template<class T>
+class IKSeqlock
+{
+public:
+    IKSeqlock() : sequence(0)
+    {
+        for(int w = 0; w < WORDS; w++)
+        {
+            words[w].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void write(const T& value)
+    {
+        uint32_t buffer[WORDS] = {0};
+        memcpy(buffer, &value, sizeof(T));
+        const unsigned s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for(int w = 0; w < WORDS; w++)
+        {
+            words[w].store(buffer[w], std::memory_order_relaxed);
+        }
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    T read() const
+    {
+        uint32_t buffer[WORDS];
+        unsigned before, after;
+        do
+        {
+            before = sequence.load(std::memory_order_acquire);
+            for(int w = 0; w < WORDS; w++)
+            {
+                buffer[w] = words[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        }
+        while((before & 1) || before != after);
+        T value;
+        memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+private:
+    enum { WORDS = (sizeof(T) + sizeof(uint32_t) - 1)/sizeof(uint32_t) };
+
+    std::atomic<unsigned> sequence;
+    std::atomic<uint32_t> words[WORDS];
+};
+
+// A leg's mailbox: the newest target posted for it, if any
+struct IKPostedTarget
+{
+    float x, y;
+    bool posted;
+};
+
+// What a leg's last tick produced, plus its running timing statistics
+template<int N>
+struct IKLegResult
+{
+    // Tick this result belongs to (0 before the first)
+    uint64_t tick;
+    float angles[N];
+    // Tracker result for the tick; evaluations is 0 if the leg had no target
+    bool converged;
+    int evaluations;
+    float error;
+    // From tick() to this result being published
+    long long latencyNs;
+    bool missedDeadline;
+    // Over all ticks so far
+    uint64_t ticks;
+    uint64_t deadlineMisses;
+    long long maxLatencyNs;
+    long long totalLatencyNs;
+};
+
+// Runs one IKTracker per leg. Targets are posted with setTarget() into a
+// per-leg mailbox that only keeps the newest one, so each leg may have its
+// own producer thread and a fast producer never loses its latest target.
+// Every tick() wakes the workers, each of which updates a fixed set of legs
+// (so their solver state stays in one core's cache) toward the newest target
+// posted for them, with the tick's deadline handed down to the solver, and
+// publishes the result through a seqlock that result() reads without ever
+// blocking the worker.
+//
+//   IKLegScheduler<2, FK> legs(6, ranges, radii, fk, 1.0f, 3);
+//   legs.setTarget(leg, target);          // any time, one thread per leg
+//   legs.tick(now + milliseconds(1));     // once per control period
+//   legs.wait();
+//   IKLegResult<2> r = legs.result(leg);  // any time, any thread
+template<int N, class FK>
+class IKLegScheduler
+{
+public:
+    // nThreads <= 0 uses one worker per leg, capped at the hardware thread
+    // count. With pinThreads, worker w is bound to CPU firstCpu + w (on
+    // Linux; elsewhere the request is ignored).
+    IKLegScheduler(int nLegs, const float ranges[][2], const float* radii, FK forwardSolve, float reqError, int nThreads = 0, int maxEvaluations = IK_TRACK_MAX_EVALS, bool pinThreads = false, int firstCpu = 0) :
+        tickCount(0),
+        stopping(false),
+        remaining(0)
+    {
+        for(int l = 0; l < nLegs; l++)
+        {
+            legs.push_back(new Leg(ranges, radii, forwardSolve, reqError, maxEvaluations));
+        }
+        int nWorkers = nThreads;
+        if(nWorkers <= 0)
+        {
+            nWorkers = (int)std::thread::hardware_concurrency();
+            nWorkers = (nWorkers <= 0) ? 1 : nWorkers;
+        }
+        nWorkers = (nWorkers > nLegs) ? nLegs : nWorkers;
+        for(int w = 0; w < nWorkers; w++)
+        {
+            workers.push_back(std::thread(&IKLegScheduler::workerLoop, this, w, nWorkers));
+            if(pinThreads)
+            {
+                pin(workers.back(), firstCpu + w);
+            }
+        }
+    }
+
+    ~IKLegScheduler()
+    {
+        wait();
+        {
+            std::lock_guard<std::mutex> guard(tickLock);
+            stopping = true;
+        }
+        tickStart.notify_all();
+        for(size_t w = 0; w < workers.size(); w++)
+        {
+            workers[w].join();
+        }
+        for(size_t l = 0; l < legs.size(); l++)
+        {
+            delete legs[l];
+        }
+    }
+
+    int size() const { return (int)legs.size(); }
+    int threads() const { return (int)workers.size(); }
+
+    // Sets the target for the next tick, replacing any target posted since
+    // the last one. Only one thread may post to a given leg.
+    void setTarget(int leg, const Vector2d& target)
+    {
+        IKPostedTarget posted = {target.x, target.y, true};
+        legs[leg]->mailbox.write(posted);
+    }
+
+    // Starts a tick; the legs' solvers give up at deadline (checked every
+    // DEADLINE_CHECK_INTERVAL descent iterations) and resume on the next
+    // tick. Waits for the previous tick to finish first.
+    void tick(std::chrono::steady_clock::time_point deadline)
+    {
+        wait();
+        {
+            std::lock_guard<std::mutex> guard(tickLock);
+            tickBegan = std::chrono::steady_clock::now();
+            tickDeadline = deadline;
+            remaining.store((int)workers.size(), std::memory_order_relaxed);
+            tickCount++;
+        }
+        tickStart.notify_all();
+    }
+
+    // Waits for the current tick to finish
+    void wait()
+    {
+        std::unique_lock<std::mutex> guard(tickLock);
+        tickDone.wait(guard, [this]{ return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    // Latest published result for leg; never blocks the workers
+    IKLegResult<N> result(int leg) const
+    {
+        return legs[leg]->published.read();
+    }
+
+private:
+    struct Leg
+    {
+        Leg(const float ranges[][2], const float* radii, FK forwardSolve, float reqError, int maxEvaluations) :
+            tracker(ranges, radii, forwardSolve, reqError, maxEvaluations),
+            hasTarget(false)
+        {
+            IKLegResult<N> res;
+            res.tick = 0;
+            for(int j = 0; j < N; j++)
+            {
+                res.angles[j] = tracker.angles()[j];
+            }
+            res.converged = false;
+            res.evaluations = 0;
+            res.error = 0.0f;
+            res.latencyNs = 0;
+            res.missedDeadline = false;
+            res.ticks = res.deadlineMisses = 0;
+            res.maxLatencyNs = res.totalLatencyNs = 0;
+            stats = res;
+            published.write(res);
+            IKPostedTarget none = {0.0f, 0.0f, false};
+            mailbox.write(none);
+        }
+
+        // Written by the leg's producer, read by its worker
+        IKSeqlock<IKPostedTarget> mailbox;
+        char mailboxPad[IK_CACHE_LINE];
+        // Only touched by the leg's worker
+        IKTracker<N, FK> tracker;
+        Vector2d target;
+        bool hasTarget;
+        IKLegResult<N> stats;
+        // Keeps readers of published off the worker's cache lines
+        char pad[IK_CACHE_LINE];
+        IKSeqlock<IKLegResult<N> > published;
+        char tailPad[IK_CACHE_LINE];
+    };
+
+    static void pin(std::thread& worker, int cpu)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set);
+#else
+        (void)worker;
+        (void)cpu;
+#endif
+    }
+
+    void update(Leg& leg, uint64_t tick, std::chrono::steady_clock::time_point began, std::chrono::steady_clock::time_point deadline)
+    {
+        const IKPostedTarget posted = leg.mailbox.read();
+        if(posted.posted)
+        {
+            leg.target = Vector2d(posted.x, posted.y);
+            leg.hasTarget = true;
+        }
+
+        IKLegResult<N>& res = leg.stats;
+        res.evaluations = 0;
+        if(leg.hasTarget)
+        {
+            IKTrackResult track = leg.tracker.update(leg.target, deadline);
+            res.converged = track.converged;
+            res.evaluations = track.evaluations;
+            res.error = track.error;
+        }
+        for(int j = 0; j < N; j++)
+        {
+            res.angles[j] = leg.tracker.angles()[j];
+        }
+
+        const std::chrono::steady_clock::time_point done = std::chrono::steady_clock::now();
+        res.tick = tick;
+        res.latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(done - began).count();
+        res.missedDeadline = (done > deadline);
+        res.ticks++;
+        res.deadlineMisses += res.missedDeadline ? 1 : 0;
+        res.maxLatencyNs = (res.latencyNs > res.maxLatencyNs) ? res.latencyNs : res.maxLatencyNs;
+        res.totalLatencyNs += res.latencyNs;
+        leg.published.write(res);
+    }
+
+    void workerLoop(int worker, int nWorkers)
+    {
+        uint64_t seen = 0;
+        for(;;)
+        {
+            std::chrono::steady_clock::time_point began, deadline;
+            {
+                std::unique_lock<std::mutex> guard(tickLock);
+                tickStart.wait(guard, [&]{ return stopping || tickCount != seen; });
+                if(stopping)
+                {
+                    return;
+                }
+                seen = tickCount;
+                began = tickBegan;
+                deadline = tickDeadline;
+            }
+
+            for(size_t l = worker; l < legs.size(); l += nWorkers)
+            {
+                update(*legs[l], seen, began, deadline);
+            }
+
+            if(remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // Take the lock so wait() can't miss the wakeup
+                std::lock_guard<std::mutex> guard(tickLock);
+                tickDone.notify_all();
+            }
+        }
+    }
+
+    IKLegScheduler(const IKLegScheduler&);
+    IKLegScheduler& operator=(const IKLegScheduler&);
+
+    std::vector<Leg*> legs;
+    std::vector<std::thread> workers;
+
+    std::mutex tickLock;
+    std::condition_variable tickStart;
+    std::condition_variable tickDone;
+    uint64_t tickCount;
+    std::chrono::steady_clock::time_point tickBegan;
+    std::chrono::steady_clock::time_point tickDeadline;
+    bool stopping;
+    std::atomic<int> remaining;
+};
+
+#endif // _IK_LEG_SCHEDULER_H_
@@ -0,0 +1,222 @@
+/*
+ *     IKLut.h
+ *
+ *     This file implements lookups into a generated IK table.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_LUT_H_
+#define _IK_LUT_H_
+
+#include "IKSolve.h"
+#include "IKLutGen.h"
+
+#include <cmath>
+#include <stdint.h>
+
+// Default value of cells that could not be solved; 126 degrees is outside
+// every joint range of the leg
+#define LUT_UNREACHABLE 126
+// How far (in cells) to look for a solved cell to warm start the fallback from
+#define LUT_SEARCH_RADIUS 3
+
+// Quantizes an angle to scale units per radian, rounding to the nearest
+// unit. Every int16 table (LegLUT.c, the chunked and mapped files, and
+// generateLUTConstexpr()) is quantized this way.
+inline int16_t lutQuantize(float angle, float scale)
+{
+    return (int16_t)std::lround(angle*scale);
+}
+
+// Looks up joint angles in a table laid out as data[(j*xSteps + i)*N + k]
+// (joint k of grid cell (i, j)), quantized to scale units per radian. Targets
+// inside four solved cells are bilinearly interpolated; targets inside four
+// unsolved cells, or that the workspace map (if given) rules out, are
+// reported unreachable at once; anywhere else the query falls back to the
+// solver, warm started from the nearest solved cell.
+//
+// Interpolated angles are only as good as the quantization, so every
+// interpolated pose is checked with one forward solve, and one that misses
+// reqError is finished by the solver from there. On the tester grid (2mm
+// cells, 100000 random queries) that is 146 of 44261 interpolated poses with
+// the default scale of whole degrees (up to 1.13mm off), and 22 with tenths
+// of a degree (scale 1800/PI, up to 1.05mm off).
+template<int N, class FK>
+class IKLut
+{
+public:
+    IKLut(const int16_t* data, const IKGrid& grid, const float ranges[][2], const float* radii, FK forwardSolve, float reqError, float scale = 180.0f/PI, int16_t sentinel = LUT_UNREACHABLE, const IKWorkspace* workspace = 0) :
+        table(data),
+        lutGrid(grid),
+        jointRanges(ranges),
+        jointRadii(radii),
+        fk(forwardSolve),
+        maxError(reqError),
+        unitsPerRadian(scale),
+        unreachable(sentinel),
+        workspaceMap(workspace)
+    {
+    }
+
+    // Returns 0 if the angles were interpolated from the table, the number
+    // of forward solves if the solver had to be used (including the one
+    // checking an interpolated pose), or -1 if the target could not be
+    // reached.
+    int lookup(const Vector2d& target, float* angles)
+    {
+        const float gx = (target.x - lutGrid.xLower)/lutGrid.xStep;
+        const float gy = (target.y - lutGrid.yLower)/lutGrid.yStep;
+        const int i = (int)std::floor(gx);
+        const int j = (int)std::floor(gy);
+        const float fx = gx - i;
+        const float fy = gy - j;
+
+        if(workspaceMap && !workspaceMap->reachable(target, maxError))
+        {
+            return -1;
+        }
+        const bool inside = (i >= 0 && j >= 0 && i + 1 < lutGrid.xSteps && j + 1 < lutGrid.ySteps);
+        if(inside && !valid(i, j) && !valid(i + 1, j) && !valid(i, j + 1) && !valid(i + 1, j + 1))
+        {
+            // Solving would only spend two full budgets finding that out
+            return -1;
+        }
+        if(inside && valid(i, j) && valid(i + 1, j) && valid(i, j + 1) && valid(i + 1, j + 1))
+        {
+            const int16_t* c00 = cell(i, j);
+            const int16_t* c10 = cell(i + 1, j);
+            const int16_t* c01 = cell(i, j + 1);
+            const int16_t* c11 = cell(i + 1, j + 1);
+            for(int k = 0; k < N; k++)
+            {
+                const float bottom = c00[k] + (c10[k] - c00[k])*fx;
+                const float top = c01[k] + (c11[k] - c01[k])*fx;
+                angles[k] = (bottom + (top - bottom)*fy)/unitsPerRadian;
+            }
+            if((fk(angles) - target).magnitude() <= maxError)
+            {
+                return 0;
+            }
+            // Quantization left the pose just short; it is the closest seed
+            // there is
+            int res = solveFrom<N>(angles, jointRanges, jointRadii, fk, target, maxError);
+            if(res != -1)
+            {
+                return res + 1;
+            }
+        }
+
+        // Near the edge of the workspace, seed the solver from the closest
+        // solved cell
+        int seed = nearestValid((int)std::floor(gx + 0.5f), (int)std::floor(gy + 0.5f));
+        if(seed != -1)
+        {
+            for(int k = 0; k < N; k++)
+            {
+                angles[k] = table[seed*N + k]/unitsPerRadian;
+            }
+            int res = solveFrom<N>(angles, jointRanges, jointRadii, fk, target, maxError);
+            if(res != -1)
+            {
+                return res;
+            }
+        }
+        return solve<N>(angles, jointRanges, jointRadii, fk, target, maxError);
+    }
+
+    // Points the lookup at a different table, e.g. after IKLutMap::refresh()
+    void setTable(const int16_t* data, const IKGrid& grid, float scale)
+    {
+        table = data;
+        lutGrid = grid;
+        unitsPerRadian = scale;
+    }
+
+private:
+    const int16_t* cell(int i, int j) const
+    {
+        return table + (j*lutGrid.xSteps + i)*N;
+    }
+
+    // Solved cells hold angles inside ranges; anything else (including the
+    // sentinel) is unreachable
+    bool valid(int i, int j) const
+    {
+        const int16_t* c = cell(i, j);
+        for(int k = 0; k < N; k++)
+        {
+            if(c[k] == unreachable ||
+               c[k] < jointRanges[k][0]*unitsPerRadian - 1.0f ||
+               c[k] > jointRanges[k][1]*unitsPerRadian + 1.0f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Index of the solved cell closest to (i, j), searching square rings out
+    // to LUT_SEARCH_RADIUS, or -1
+    int nearestValid(int i, int j) const
+    {
+        int best = -1;
+        int bestDist = 0;
+        for(int r = 0; r <= LUT_SEARCH_RADIUS && best == -1; r++)
+        {
+            for(int dj = -r; dj <= r; dj++)
+            {
+                for(int di = -r; di <= r; di++)
+                {
+                    if((di != -r && di != r && dj != -r && dj != r) ||
+                       i + di < 0 || j + dj < 0 || i + di >= lutGrid.xSteps || j + dj >= lutGrid.ySteps ||
+                       !valid(i + di, j + dj))
+                    {
+                        continue;
+                    }
+                    const int dist = di*di + dj*dj;
+                    if(best == -1 || dist < bestDist)
+                    {
+                        best = (j + dj)*lutGrid.xSteps + (i + di);
+                        bestDist = dist;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    const int16_t* table;
+    IKGrid lutGrid;
+    const float (*jointRanges)[2];
+    const float* jointRadii;
+    FK fk;
+    float maxError;
+    float unitsPerRadian;
+    int16_t unreachable;
+    const IKWorkspace* workspaceMap;
+};
+
+// Deduces the forward kinematics type, e.g.
+// auto lut = makeLut<2>(legPosLUT, grid, ranges, radii, [](float* a){ return ...; }, 1.0f);
+template<int N, class FK>
+inline IKLut<N, FK> makeLut(const int16_t* data, const IKGrid& grid, const float ranges[][2], const float* radii, FK forwardSolve, float reqError, float scale = 180.0f/PI, int16_t sentinel = LUT_UNREACHABLE, const IKWorkspace* workspace = 0)
+{
+    return IKLut<N, FK>(data, grid, ranges, radii, forwardSolve, reqError, scale, sentinel, workspace);
+}
+
+#endif // _IK_LUT_H_
@@ -0,0 +1,183 @@
+/*
+ *     IKLutFile.cpp
+ *
+ *     This file implements reading and writing the chunked binary lookup
+ *     table file.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "IKLutFile.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+
+uint64_t lutChecksum(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t b = 0; b < size; b++)
+    {
+        hash ^= bytes[b];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t lutGeometryHash(const float* values, int count, uint64_t hash)
+{
+    return lutChecksum(values, count*sizeof(float), hash);
+}
+
+static uint64_t headerChecksum(const IKLutFileHeader& header)
+{
+    return lutChecksum(&header, offsetof(IKLutFileHeader, checksum));
+}
+
+IKLutFileHeader makeLutFileHeader(const IKGrid& grid, int nJoints, IKLutValueType valueType, uint64_t geometryHash, float scale, int16_t sentinel)
+{
+    IKLutFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LUT_FILE_MAGIC;
+    header.version = LUT_FILE_VERSION;
+    header.valueType = valueType;
+    header.nJoints = nJoints;
+    header.xSteps = grid.xSteps;
+    header.ySteps = grid.ySteps;
+    header.xLower = grid.xLower;
+    header.yLower = grid.yLower;
+    header.xStep = grid.xStep;
+    header.yStep = grid.yStep;
+    header.scale = (valueType == LUT_INT16) ? scale : 1.0f;
+    header.sentinel = (valueType == LUT_INT16) ? sentinel : 0;
+    header.rowsPerChunk = LUT_FILE_ROWS_PER_CHUNK;
+    header.geometryHash = geometryHash;
+    header.checksum = headerChecksum(header);
+    return header;
+}
+
+IKGrid lutFileGrid(const IKLutFileHeader& header)
+{
+    IKGrid grid = {header.xLower, header.yLower, header.xStep, header.yStep, header.xSteps, header.ySteps};
+    return grid;
+}
+
+uint32_t lutChunkCount(const IKLutFileHeader& header)
+{
+    return (header.ySteps + header.rowsPerChunk - 1)/header.rowsPerChunk;
+}
+
+int lutChunkRows(const IKLutFileHeader& header, uint32_t index)
+{
+    const int first = index*header.rowsPerChunk;
+    return (first + (int)header.rowsPerChunk <= header.ySteps) ? (int)header.rowsPerChunk : (header.ySteps - first);
+}
+
+size_t lutChunkBytes(const IKLutFileHeader& header, uint32_t index)
+{
+    const size_t valueSize = (header.valueType == LUT_INT16) ? sizeof(int16_t) : sizeof(float);
+    return (size_t)lutChunkRows(header, index)*header.xSteps*header.nJoints*valueSize;
+}
+
+bool readLutFileHeader(FILE* file, IKLutFileHeader& header)
+{
+    if(fseek(file, 0, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, file) != 1)
+    {
+        return false;
+    }
+    return header.magic == LUT_FILE_MAGIC &&
+           header.version == LUT_FILE_VERSION &&
+           header.checksum == headerChecksum(header) &&
+           (header.valueType == LUT_FLOAT32 || header.valueType == LUT_INT16) &&
+           (header.valueType == LUT_INT16 ? (header.sentinel >= INT16_MIN && header.sentinel <= INT16_MAX) : (header.sentinel == 0)) &&
+           header.nJoints > 0 && header.xSteps > 0 && header.ySteps > 0 && header.rowsPerChunk > 0;
+}
+
+bool readLutChunk(FILE* file, const IKLutFileHeader& header, uint32_t index, void* values)
+{
+    IKLutChunkHeader chunk;
+    if(fread(&chunk, sizeof(chunk), 1, file) != 1 ||
+       chunk.index != index ||
+       (int)chunk.rows != lutChunkRows(header, index))
+    {
+        return false;
+    }
+    const size_t bytes = lutChunkBytes(header, index);
+    return fread(values, 1, bytes, file) == bytes && lutChecksum(values, bytes) == chunk.checksum;
+}
+
+int openLutFile(const char* path, const IKLutFileHeader& header, FILE** file)
+{
+    int done = 0;
+    FILE* f = fopen(path, "r+b");
+    if(f)
+    {
+        // Keep the complete chunks of a matching table, and overwrite from
+        // the first missing or damaged one. Chunk sizes are fixed by the
+        // header, so a rewritten chunk always covers a partial one.
+        IKLutFileHeader existing;
+        if(readLutFileHeader(f, existing) && memcmp(&existing, &header, sizeof(header)) == 0)
+        {
+            const uint32_t chunks = lutChunkCount(header);
+            char* values = new char[lutChunkBytes(header, 0)];
+            long end = ftell(f);
+            while((uint32_t)done < chunks && readLutChunk(f, header, done, values))
+            {
+                done++;
+                end = ftell(f);
+            }
+            delete[] values;
+            if(fseek(f, end, SEEK_SET) != 0)
+            {
+                fclose(f);
+                return -1;
+            }
+            *file = f;
+            return done;
+        }
+        fclose(f);
+    }
+
+    f = fopen(path, "w+b");
+    if(!f || fwrite(&header, sizeof(header), 1, f) != 1 || fflush(f) != 0)
+    {
+        if(f)
+        {
+            fclose(f);
+        }
+        return -1;
+    }
+    *file = f;
+    return 0;
+}
+
+bool writeLutChunk(FILE* file, const IKLutFileHeader& header, uint32_t index, const void* values)
+{
+    IKLutChunkHeader chunk;
+    const size_t bytes = lutChunkBytes(header, index);
+    chunk.index = index;
+    chunk.rows = lutChunkRows(header, index);
+    chunk.checksum = lutChecksum(values, bytes);
+    // Make the chunk durable before the next one is started, so a crash
+    // loses at most the chunk in progress
+    return fwrite(&chunk, sizeof(chunk), 1, file) == 1 &&
+           fwrite(values, 1, bytes, file) == bytes &&
+           fflush(file) == 0 &&
+           fsync(fileno(file)) == 0;
+}
@@ -0,0 +1,177 @@
+/*
+ *     IKLutFile.h
+ *
+ *     This file declares the chunked binary lookup table file, and the
+ *     streaming generator that writes it.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_LUT_FILE_H_
+#define _IK_LUT_FILE_H_
+
+#include "IKLut.h"
+#include "IKLutGen.h"
+
+#include <cmath>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// File layout (native byte order):
+//
+//   IKLutFileHeader
+//   chunk 0: IKLutChunkHeader, rows*xSteps*nJoints values
+//   chunk 1: ...
+//
+// Every chunk but the last holds header.rowsPerChunk grid rows. Values are
+// joint angles, either as floats in radians (NaN where the target could not
+// be reached) or as int16 in 1/scale radians, quantized by lutQuantize()
+// (header.sentinel where it could not). A chunk is only counted as complete if its checksum matches, so an
+// interrupted run can be resumed from the last complete chunk.
+
+#define LUT_FILE_MAGIC 0x434c4b49 // "IKLC"
+#define LUT_FILE_VERSION 2
+// A multiple of IK_LUT_TILE, so chunks split the grid along tile boundaries
+#define LUT_FILE_ROWS_PER_CHUNK 16
+
+enum IKLutValueType
+{
+    LUT_FLOAT32 = 0,
+    LUT_INT16 = 1
+};
+
+struct IKLutFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t valueType;
+    uint32_t nJoints;
+    int32_t xSteps, ySteps;
+    float xLower, yLower;
+    float xStep, yStep;
+    // int16 units per radian (LUT_INT16 only)
+    float scale;
+    // Value of cells that could not be solved (LUT_INT16 only)
+    int32_t sentinel;
+    uint32_t reserved;
+    uint32_t rowsPerChunk;
+    // Identifies the leg geometry the table was generated for, see
+    // lutGeometryHash()
+    uint64_t geometryHash;
+    // lutChecksum() of everything above
+    uint64_t checksum;
+};
+
+struct IKLutChunkHeader
+{
+    uint32_t index;
+    uint32_t rows;
+    // lutChecksum() of the chunk's values
+    uint64_t checksum;
+};
+
+// 64-bit FNV-1a, continuing from hash
+uint64_t lutChecksum(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL);
+
+// Hash of the geometry parameters (radii, offsets, ranges, ...) a table
+// depends on; chain calls to cover several arrays
+uint64_t lutGeometryHash(const float* values, int count, uint64_t hash = 14695981039346656037ULL);
+
+// Fills in magic, version, rowsPerChunk and the grid fields of a header
+IKLutFileHeader makeLutFileHeader(const IKGrid& grid, int nJoints, IKLutValueType valueType, uint64_t geometryHash, float scale = 180.0f/PI, int16_t sentinel = LUT_UNREACHABLE);
+
+IKGrid lutFileGrid(const IKLutFileHeader& header);
+
+uint32_t lutChunkCount(const IKLutFileHeader& header);
+// Grid rows, and bytes of values, in chunk index
+int lutChunkRows(const IKLutFileHeader& header, uint32_t index);
+size_t lutChunkBytes(const IKLutFileHeader& header, uint32_t index);
+
+// Opens path for writing with the given header. If the file already holds a
+// table with an identical header, its complete chunks are kept and the file
+// is positioned after them; otherwise it is started afresh. Returns the
+// number of complete chunks, or -1 on error.
+int openLutFile(const char* path, const IKLutFileHeader& header, FILE** file);
+
+// Appends chunk index holding values and flushes it to disk
+bool writeLutChunk(FILE* file, const IKLutFileHeader& header, uint32_t index, const void* values);
+
+// Reads and validates the header; the file is left positioned at chunk 0
+bool readLutFileHeader(FILE* file, IKLutFileHeader& header);
+
+// Reads the next chunk into values (lutChunkBytes() of them) and checks it
+bool readLutChunk(FILE* file, const IKLutFileHeader& header, uint32_t index, void* values);
+
+// Generates the table for grid into path one chunk at a time, so memory use
+// is bounded by a single chunk whatever the grid size. Resumes from the last
+// complete chunk if the file already holds part of the same table; since
+// tiles never span chunks, a resumed file is identical to an uninterrupted
+// one. A workspace map, if given, is passed on to generateLUT(). Returns false
+// on I/O errors, or if a solved angle quantizes to the sentinel.
+template<int N, class FK>
+bool generateLutFile(const char* path, IKThreadPool& pool, const IKGrid& grid, const float ranges[][2], const float* radii, FK forwardSolve, const float& reqError, IKLutValueType valueType, uint64_t geometryHash, const IKWorkspace* workspace = 0)
+{
+    const IKLutFileHeader header = makeLutFileHeader(grid, N, valueType, geometryHash);
+    FILE* file;
+    int done = openLutFile(path, header, &file);
+    if(done < 0)
+    {
+        return false;
+    }
+
+    const uint32_t chunks = lutChunkCount(header);
+    std::vector<float> table(header.rowsPerChunk*grid.xSteps*N);
+    std::vector<int> results(header.rowsPerChunk*grid.xSteps);
+    std::vector<int16_t> quantized(header.rowsPerChunk*grid.xSteps*N);
+    for(uint32_t c = done; c < chunks; c++)
+    {
+        IKGrid band = grid;
+        band.yLower = grid.yLower + (c*header.rowsPerChunk)*grid.yStep;
+        band.ySteps = lutChunkRows(header, c);
+        generateLUT<N>(pool, band, ranges, radii, forwardSolve, reqError, &table[0], &results[0], workspace);
+
+        for(int cell = 0; cell < band.ySteps*band.xSteps; cell++)
+        {
+            for(int k = 0; k < N; k++)
+            {
+                if(results[cell] == -1)
+                {
+                    table[cell*N + k] = NAN;
+                    quantized[cell*N + k] = (int16_t)header.sentinel;
+                }
+                else
+                {
+                    quantized[cell*N + k] = lutQuantize(table[cell*N + k], header.scale);
+                    if(valueType == LUT_INT16 && quantized[cell*N + k] == header.sentinel)
+                    {
+                        fclose(file);
+                        return false;
+                    }
+                }
+            }
+        }
+        if(!writeLutChunk(file, header, c, (valueType == LUT_INT16) ? (const void*)&quantized[0] : (const void*)&table[0]))
+        {
+            fclose(file);
+            return false;
+        }
+    }
+    return fclose(file) == 0;
+}
+
+#endif // _IK_LUT_FILE_H_
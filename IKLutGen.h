@@ -0,0 +1,122 @@
+/*
+ *     IKLutGen.h
+ *
+ *     This file implements the parallel lookup table generator.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_LUT_GEN_H_
+#define _IK_LUT_GEN_H_
+
+#include "IKSolve.h"
+#include "IKThreadPool.h"
+
+// Edge length (in cells) of the square tiles handed to the thread pool
+#define IK_LUT_TILE 8
+
+// Regular grid of end effector targets. Cell (i, j) is the target
+// <xLower + i*xStep, yLower + j*yStep>.
+struct IKGrid
+{
+    float xLower, yLower;
+    float xStep, yStep;
+    int xSteps, ySteps;
+};
+
+// Solves one tile of the grid. The first cell of the tile is solved from a
+// cold start; every other cell seeds from the cell below it (or to its left
+// on the tile's first row, or when the cell below failed) and only falls
+// back to a cold start if the warm start times out. Seeds never cross tile
+// boundaries, so the result does not depend on how tiles are scheduled.
+// Cells a workspace map rejects are marked -1 with zero angles unsolved.
+template<int N, class FK>
+void generateLUTTile(const IKGrid& grid, int i0, int j0, const float ranges[][2], const float* radii, FK& forwardSolve, const float reqError, float* table, int* results, const IKWorkspace* workspace = 0)
+{
+    const int i1 = (i0 + IK_LUT_TILE < grid.xSteps) ? (i0 + IK_LUT_TILE) : grid.xSteps;
+    const int j1 = (j0 + IK_LUT_TILE < grid.ySteps) ? (j0 + IK_LUT_TILE) : grid.ySteps;
+    float angles[N];
+    for(int j = j0; j < j1; j++)
+    {
+        for(int i = i0; i < i1; i++)
+        {
+            const int cell = j*grid.xSteps + i;
+            const Vector2d target(grid.xLower + (i*grid.xStep), grid.yLower + (j*grid.yStep));
+            if(workspace && !workspace->reachable(target, reqError))
+            {
+                for(int k = 0; k < N; k++)
+                {
+                    table[cell*N + k] = 0.0f;
+                }
+                results[cell] = -1;
+                continue;
+            }
+
+            int seed = -1;
+            if(j > j0 && results[cell - grid.xSteps] != -1)
+            {
+                seed = cell - grid.xSteps;
+            }
+            else if(i > i0 && results[cell - 1] != -1)
+            {
+                seed = cell - 1;
+            }
+
+            int res = -1;
+            if(seed != -1)
+            {
+                for(int k = 0; k < N; k++)
+                {
+                    angles[k] = table[seed*N + k];
+                }
+                res = solveFrom<N>(angles, ranges, radii, forwardSolve, target, reqError);
+            }
+            if(res == -1)
+            {
+                for(int k = 0; k < N; k++)
+                {
+                    angles[k] = 0.0f;
+                }
+                res = solve<N>(angles, ranges, radii, forwardSolve, target, reqError);
+            }
+
+            for(int k = 0; k < N; k++)
+            {
+                table[cell*N + k] = angles[k];
+            }
+            results[cell] = res;
+        }
+    }
+}
+
+// Fills table[(j*grid.xSteps + i)*N + k] with joint k of cell (i, j) and
+// results[j*grid.xSteps + i] with the solve() result for that cell (-1 if it
+// could not be reached). Tiles of IK_LUT_TILE x IK_LUT_TILE cells are spread
+// over the pool; the output is identical for any number of threads.
+template<int N, class FK>
+void generateLUT(IKThreadPool& pool, const IKGrid& grid, const float ranges[][2], const float* radii, FK forwardSolve, const float& reqError, float* table, int* results, const IKWorkspace* workspace = 0)
+{
+    const int xTiles = (grid.xSteps + IK_LUT_TILE - 1)/IK_LUT_TILE;
+    const int yTiles = (grid.ySteps + IK_LUT_TILE - 1)/IK_LUT_TILE;
+    pool.run(xTiles*yTiles, [&](int tile, int)
+    {
+        FK localSolve = forwardSolve;
+        generateLUTTile<N>(grid, (tile % xTiles)*IK_LUT_TILE, (tile / xTiles)*IK_LUT_TILE, ranges, radii, localSolve, reqError, table, results, workspace);
+    });
+}
+
+#endif // _IK_LUT_GEN_H_
@@ -0,0 +1,232 @@
+/*
+ *     IKLutMap.cpp
+ *
+ *     This file implements writing and mapping the flat binary lookup table
+ *     file.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "IKLutMap.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+static uint64_t headerChecksum(const IKLutMapHeader& header)
+{
+    return lutChecksum(&header, offsetof(IKLutMapHeader, checksum));
+}
+
+static size_t dataBytes(const IKLutMapHeader& header)
+{
+    return (size_t)header.xSteps*header.ySteps*header.nJoints*sizeof(int16_t);
+}
+
+// Writes to a temporary file beside path, then renames it into place
+static bool replaceFile(const char* path, const IKLutMapHeader& header, FILE* chunked, const IKLutFileHeader* chunkedHeader, const int16_t* data)
+{
+    const string tmpPath = string(path) + ".tmp";
+    FILE* f = fopen(tmpPath.c_str(), "wb");
+    if(!f)
+    {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if(chunked)
+    {
+        vector<int16_t> values(lutChunkBytes(*chunkedHeader, 0)/sizeof(int16_t));
+        for(uint32_t c = 0; ok && c < lutChunkCount(*chunkedHeader); c++)
+        {
+            const size_t bytes = lutChunkBytes(*chunkedHeader, c);
+            ok = readLutChunk(chunked, *chunkedHeader, c, &values[0]) && fwrite(&values[0], 1, bytes, f) == bytes;
+        }
+    }
+    else
+    {
+        ok = ok && fwrite(data, 1, dataBytes(header), f) == dataBytes(header);
+    }
+    ok = ok && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    ok = (fclose(f) == 0) && ok;
+    if(!ok || rename(tmpPath.c_str(), path) != 0)
+    {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool writeLutMap(const char* path, IKLutMapHeader header, const int16_t* data)
+{
+    header.magic = LUT_MAP_MAGIC;
+    header.version = LUT_MAP_VERSION;
+    header.reserved = 0;
+    header.dataChecksum = lutChecksum(data, dataBytes(header));
+    header.checksum = headerChecksum(header);
+    return replaceFile(path, header, 0, 0, data);
+}
+
+bool packLutFile(const char* chunkedPath, const char* mapPath)
+{
+    FILE* chunked = fopen(chunkedPath, "rb");
+    if(!chunked)
+    {
+        return false;
+    }
+    IKLutFileHeader in;
+    if(!readLutFileHeader(chunked, in) || in.valueType != LUT_INT16)
+    {
+        fclose(chunked);
+        return false;
+    }
+
+    // The data checksum runs over the chunks in order, so it can be worked
+    // out in a first pass without holding the table
+    IKLutMapHeader header;
+    header.magic = LUT_MAP_MAGIC;
+    header.version = LUT_MAP_VERSION;
+    header.nJoints = in.nJoints;
+    header.xSteps = in.xSteps;
+    header.ySteps = in.ySteps;
+    header.xLower = in.xLower;
+    header.yLower = in.yLower;
+    header.xStep = in.xStep;
+    header.yStep = in.yStep;
+    header.scale = in.scale;
+    header.sentinel = in.sentinel;
+    header.reserved = 0;
+    header.geometryHash = in.geometryHash;
+    header.dataChecksum = lutChecksum(0, 0);
+    vector<int16_t> values(lutChunkBytes(in, 0)/sizeof(int16_t));
+    bool ok = true;
+    for(uint32_t c = 0; ok && c < lutChunkCount(in); c++)
+    {
+        ok = readLutChunk(chunked, in, c, &values[0]);
+        header.dataChecksum = lutChecksum(&values[0], lutChunkBytes(in, c), header.dataChecksum);
+    }
+    header.checksum = headerChecksum(header);
+
+    ok = ok && readLutFileHeader(chunked, in) && replaceFile(mapPath, header, chunked, &in, 0);
+    fclose(chunked);
+    return ok;
+}
+
+IKLutMap::IKLutMap() :
+    expectedJointCount(0),
+    expectedGeometry(0),
+    base(0),
+    length(0),
+    device(0),
+    inode(0)
+{
+}
+
+IKLutMap::~IKLutMap()
+{
+    close();
+}
+
+bool IKLutMap::open(const char* path, uint32_t expectedJoints, uint64_t geometryHash)
+{
+    int fd = ::open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(IKLutMapHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping outlives the descriptor
+    ::close(fd);
+    if(view == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const IKLutMapHeader& h = *(const IKLutMapHeader*)view;
+    const int16_t* table = (const int16_t*)((const char*)view + sizeof(IKLutMapHeader));
+    if(h.magic != LUT_MAP_MAGIC ||
+       h.version != LUT_MAP_VERSION ||
+       h.checksum != headerChecksum(h) ||
+       (geometryHash != 0 && h.geometryHash != geometryHash) ||
+       h.nJoints == 0 || h.nJoints != expectedJoints || h.xSteps <= 0 || h.ySteps <= 0 ||
+       h.sentinel < INT16_MIN || h.sentinel > INT16_MAX ||
+       (size_t)st.st_size != sizeof(IKLutMapHeader) + dataBytes(h) ||
+       h.dataChecksum != lutChecksum(table, dataBytes(h)))
+    {
+        munmap(view, st.st_size);
+        return false;
+    }
+
+    close();
+    filePath = path;
+    expectedJointCount = expectedJoints;
+    expectedGeometry = geometryHash;
+    base = view;
+    length = st.st_size;
+    device = st.st_dev;
+    inode = st.st_ino;
+    return true;
+}
+
+void IKLutMap::close()
+{
+    if(base)
+    {
+        munmap(base, length);
+        base = 0;
+        length = 0;
+    }
+}
+
+bool IKLutMap::refresh()
+{
+    // A writer renames a complete file over the path, which gives it a new
+    // inode; a file still being written never appears under the path
+    struct stat st;
+    if(filePath.empty() || stat(filePath.c_str(), &st) != 0 ||
+       (base && st.st_dev == device && st.st_ino == inode))
+    {
+        return false;
+    }
+    const string path = filePath;
+    if(open(path.c_str(), expectedJointCount, expectedGeometry))
+    {
+        return true;
+    }
+    // Keep the old table, and don't revalidate the rejected file every call
+    device = st.st_dev;
+    inode = st.st_ino;
+    return false;
+}
+
+IKGrid IKLutMap::grid() const
+{
+    const IKLutMapHeader& h = header();
+    IKGrid g = {h.xLower, h.yLower, h.xStep, h.yStep, h.xSteps, h.ySteps};
+    return g;
+}
@@ -0,0 +1,142 @@
+/*
+ *     IKLutMap.h
+ *
+ *     This file declares the flat binary lookup table file, which controller
+ *     processes map into memory instead of compiling the table in.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_LUT_MAP_H_
+#define _IK_LUT_MAP_H_
+
+#include "IKLutFile.h"
+
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+// File layout (native byte order): an IKLutMapHeader followed directly by
+// the int16 table laid out as IKLut expects, data[(j*xSteps + i)*nJoints + k].
+// Unlike the chunked generator output the table is contiguous, so a mapped
+// file can be handed to IKLut without copying, and every process mapping the
+// same file shares one page cached copy.
+
+#define LUT_MAP_MAGIC 0x4d4c4b49 // "IKLM"
+#define LUT_MAP_VERSION 1
+
+struct IKLutMapHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nJoints;
+    int32_t xSteps, ySteps;
+    float xLower, yLower;
+    float xStep, yStep;
+    // Table units per radian
+    float scale;
+    // Value of cells that could not be solved
+    int32_t sentinel;
+    uint32_t reserved;
+    // See lutGeometryHash()
+    uint64_t geometryHash;
+    // lutChecksum() of the table
+    uint64_t dataChecksum;
+    // lutChecksum() of everything above
+    uint64_t checksum;
+};
+
+// Writes header (checksums are filled in here) and data to path. The file is
+// written next to path and renamed over it once complete, so a process
+// mapping path sees either the old table or the new one, never a mix.
+bool writeLutMap(const char* path, IKLutMapHeader header, const int16_t* data);
+
+// Converts a chunked int16 file from generateLutFile() into the mapped
+// format, one chunk at a time
+bool packLutFile(const char* chunkedPath, const char* mapPath);
+
+// Read-only view of a mapped table file.
+//
+//   IKLutMap map;
+//   map.open("LegLUT.map", 2, geometryHash);
+//   auto lut = makeLut<2>(map.data(), map.grid(), ranges, radii, fk, 1.0f, map.scale(), map.sentinel());
+//   ...
+//   if(map.refresh())
+//   {
+//       lut.setTable(map.data(), map.grid(), map.scale());
+//   }
+//
+// refresh() unmaps the old table, so it must be called from the thread doing
+// the lookups (e.g. between control ticks), never concurrently with them.
+class IKLutMap
+{
+public:
+    IKLutMap();
+    ~IKLutMap();
+
+    // Maps path and validates its header, checksums, joint count (which must
+    // be the N the table will be looked up with) and geometry (pass a
+    // geometryHash of 0 to accept any). Returns false, leaving any table
+    // already mapped in place, if the file is missing or invalid.
+    bool open(const char* path, uint32_t expectedJoints, uint64_t geometryHash);
+    void close();
+
+    // Remaps the file if it has been replaced since it was mapped, with the
+    // same checks as open(). Returns true if a new table was mapped.
+    bool refresh();
+
+    bool mapped() const
+    {
+        return base != 0;
+    }
+    const IKLutMapHeader& header() const
+    {
+        return *(const IKLutMapHeader*)base;
+    }
+    const int16_t* data() const
+    {
+        return (const int16_t*)((const char*)base + sizeof(IKLutMapHeader));
+    }
+    IKGrid grid() const;
+    uint32_t nJoints() const
+    {
+        return header().nJoints;
+    }
+    float scale() const
+    {
+        return header().scale;
+    }
+    int16_t sentinel() const
+    {
+        return (int16_t)header().sentinel;
+    }
+
+private:
+    IKLutMap(const IKLutMap&);
+    IKLutMap& operator=(const IKLutMap&);
+
+    std::string filePath;
+    uint32_t expectedJointCount;
+    uint64_t expectedGeometry;
+    void* base;
+    size_t length;
+    // Identity of the mapped file, to notice when path is renamed over
+    dev_t device;
+    ino_t inode;
+};
+
+#endif // _IK_LUT_MAP_H_
@@ -0,0 +1,214 @@
+/*
+ *     IKMultiStart.h
+ *
+ *     This file implements the multi-start solver, which runs the coordinate
+ *     descent from several initial poses at once on a thread pool.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_MULTI_START_H_
+#define _IK_MULTI_START_H_
+
+#include "IKSolve.h"
+#include "IKThreadPool.h"
+
+#include <atomic>
+
+// Most initial poses tried by solveMultiStart(), see multiStartSeeds()
+#define IK_MULTI_START_SEEDS 5
+
+enum IKStartPreference
+{
+    // Take whichever run converges first and cancel the others
+    IK_PREFER_FIRST,
+    // Let every run finish and take the solution closest (in joint space)
+    // to the pose passed in
+    IK_PREFER_CLOSEST
+};
+
+// Fills seeds with the initial poses: all zeros (where solve() starts), the
+// pose passed in (e.g. the previous solution), the middle of each range, and
+// a pair with the joints alternately a quarter of the way in from opposite
+// ends of their ranges, which on a two-link leg is the elbow-up/elbow-down
+// pair. Seeds are clamped into ranges, and one that repeats an earlier seed
+// (e.g. the zero pose passed in) is dropped; returns how many are left.
+template<int N>
+inline int multiStartSeeds(const float* angles, const float ranges[][2], float seeds[IK_MULTI_START_SEEDS][N])
+{
+    for(int j = 0; j < N; j++)
+    {
+        const float lower = ranges[j][0];
+        const float span = ranges[j][1] - ranges[j][0];
+        seeds[0][j] = 0.0f;
+        seeds[1][j] = angles[j];
+        seeds[2][j] = lower + span*0.5f;
+        seeds[3][j] = lower + span*((j % 2) ? 0.75f : 0.25f);
+        seeds[4][j] = lower + span*((j % 2) ? 0.25f : 0.75f);
+    }
+
+    int nSeeds = 0;
+    for(int s = 0; s < IK_MULTI_START_SEEDS; s++)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            float seed = seeds[s][j];
+            seed = (seed > ranges[j][1]) ? ranges[j][1] : seed;
+            seed = (seed < ranges[j][0]) ? ranges[j][0] : seed;
+            seeds[nSeeds][j] = seed;
+        }
+        bool repeated = false;
+        for(int t = 0; t < nSeeds && !repeated; t++)
+        {
+            repeated = true;
+            for(int j = 0; j < N; j++)
+            {
+                repeated = repeated && (seeds[t][j] == seeds[nSeeds][j]);
+            }
+        }
+        nSeeds += repeated ? 0 : 1;
+    }
+    return nSeeds;
+}
+
+// Same as solve<N>() with the descent engine, but descends from every seed
+// of multiStartSeeds() concurrently on pool, so a target the descent misses
+// from one start can still be found from another. angles holds the current
+// pose on entry and the chosen solution on return; the return value is the
+// chosen run's evaluation count, or -1 if no run converged (with
+// options.bestEffort, angles is then left at the closest pose any run
+// found). With IK_PREFER_FIRST the runs share a cancel flag, replacing
+// options.cancel, and which run wins a close race is not deterministic.
+//
+// A pool of fewer than two threads could only queue the runs behind each
+// other, multiplying the time spent on a target no seed reaches. The seeds
+// are then tried one after another in the order above, sharing the one
+// options.maxEvaluations budget, and the first run to converge is taken
+// whatever prefer says. The first run is solve()'s own, so the result is
+// never worse and the latency never longer than a single solve(); a run
+// that fails spends the whole budget, so the later seeds only help when a
+// deadline or cancel flag, rather than the budget, is what stops it.
+// Runs copy forwardSolve, so a stateful FK such as IKChain is fine. Like
+// IKThreadPool::run(), not reentrant on the same pool.
+template<int N, class FK>
+int solveMultiStart(IKThreadPool& pool, float* angles, const float ranges[][2], const float* radii, FK forwardSolve, const Vector2d& target, const float& reqError, IKStartPreference prefer = IK_PREFER_FIRST, IKSolveOptions options = IKSolveOptions())
+{
+    if(options.workspace && !options.workspace->reachable(target, reqError))
+    {
+        // No seed will do better; let solve() turn it away
+        return solve<N>(angles, ranges, radii, forwardSolve, target, reqError, options);
+    }
+
+    float runs[IK_MULTI_START_SEEDS][N];
+    int results[IK_MULTI_START_SEEDS];
+    const int nSeeds = multiStartSeeds<N>(angles, ranges, runs);
+    options.coldStart = false;
+    int chosen = -1;
+
+    if(pool.size() < 2)
+    {
+        int remaining = options.maxEvaluations;
+        for(int s = 0; s < nSeeds; s++)
+        {
+            results[s] = -1;
+            if(remaining <= 0 || chosen != -1)
+            {
+                continue;
+            }
+            IKEvaluationCounter counter;
+            IKSolveOptions seedOptions = options;
+            seedOptions.maxEvaluations = remaining;
+            results[s] = solveImplStats<N>(runs[s], ranges, radii, N, forwardSolve, target, reqError, seedOptions, counter);
+            remaining -= (int)counter.evaluations;
+            chosen = (results[s] != -1) ? s : -1;
+        }
+    }
+    else
+    {
+        std::atomic<bool> cancelled(false);
+        std::atomic<int> first(-1);
+        options.cancel = (prefer == IK_PREFER_FIRST) ? &cancelled : 0;
+
+        pool.run(nSeeds, [&](int s, int)
+        {
+            results[s] = -1;
+            if(cancelled.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            results[s] = solve<N>(runs[s], ranges, radii, forwardSolve, target, reqError, options);
+            int none = -1;
+            if(results[s] != -1 && first.compare_exchange_strong(none, s))
+            {
+                cancelled.store(true, std::memory_order_relaxed);
+            }
+        });
+
+        chosen = first.load();
+        if(prefer == IK_PREFER_CLOSEST)
+        {
+            float closest = -1.0f;
+            for(int s = 0; s < nSeeds; s++)
+            {
+                if(results[s] == -1)
+                {
+                    continue;
+                }
+                float distance = 0.0f;
+                for(int j = 0; j < N; j++)
+                {
+                    distance += (runs[s][j] - angles[j])*(runs[s][j] - angles[j]);
+                }
+                if(closest < 0.0f || distance < closest)
+                {
+                    closest = distance;
+                    chosen = s;
+                }
+            }
+        }
+    }
+
+    if(chosen == -1 && options.bestEffort)
+    {
+        float bestError = -1.0f;
+        for(int s = 0; s < nSeeds; s++)
+        {
+            float error = (forwardSolve(runs[s]) - target).magnitude();
+            if(bestError < 0.0f || error < bestError)
+            {
+                bestError = error;
+                chosen = s;
+            }
+        }
+        for(int j = 0; j < N; j++)
+        {
+            angles[j] = runs[chosen][j];
+        }
+        return -1;
+    }
+    if(chosen == -1)
+    {
+        return -1;
+    }
+    for(int j = 0; j < N; j++)
+    {
+        angles[j] = runs[chosen][j];
+    }
+    return results[chosen];
+}
+
+#endif // _IK_MULTI_START_H_
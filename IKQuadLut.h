@@ -0,0 +1,518 @@
+/*
+ *     IKQuadLut.h
+ *
+ *     This file implements an adaptive IK table, stored as a quadtree that
+ *     is only refined where interpolating between solved corners is not
+ *     accurate enough.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_QUAD_LUT_H_
+#define _IK_QUAD_LUT_H_
+
+#include "IKSolve.h"
+#include "IKLutFile.h"
+#include "IKWorkspace.h"
+
+#include <cmath>
+#include <map>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Depth limits of the tree; every cell is split at least QUAD_LUT_MIN_DEPTH
+// times so small features can't hide between the root's corners
+#define QUAD_LUT_MAX_DEPTH 8
+#define QUAD_LUT_MIN_DEPTH 2
+
+#define QUAD_LUT_MAGIC 0x514c4b49 // "IKLQ"
+#define QUAD_LUT_VERSION 2
+
+// Node encoding: an internal node holds the index of the first of its four
+// children (which are stored together, ordered low x low y, high x low y,
+// low x high y, high x high y); a leaf has QUAD_LUT_LEAF set and holds the
+// index of its corner values, QUAD_LUT_UNREACHABLE, or QUAD_LUT_SOLVE for
+// cells with nothing to interpolate that may still hold reachable targets.
+#define QUAD_LUT_LEAF 0x80000000u
+#define QUAD_LUT_UNREACHABLE 0xffffffffu
+#define QUAD_LUT_SOLVE 0xfffffffeu
+
+struct IKQuadLutHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nJoints;
+    uint32_t maxDepth;
+    float xLower, yLower;
+    float xSize, ySize;
+    uint32_t nodeCount;
+    uint32_t valueCount;
+    // IKEngine the corners were solved with, and fallbacks use
+    uint32_t engine;
+    uint32_t reserved;
+    // See lutGeometryHash()
+    uint64_t geometryHash;
+    // lutChecksum() of the nodes then the values
+    uint64_t dataChecksum;
+    // lutChecksum() of everything above
+    uint64_t checksum;
+};
+
+// Adaptive IK table. Each leaf holds the joint angles at its four corners and
+// is bilinearly interpolated like a cell of IKLut, but leaves are only split
+// where interpolation misses the solved end effector position by more than
+// the build tolerance; unreachable regions collapse into single leaves.
+// Leaves at the maximum depth with only some corners solved fall back to the
+// solver, warm started from a solved corner.
+//
+// The tree is two flat arrays, nodes (one uint32 each) and leaf values, so
+// a lookup is a short descent through contiguous memory and the whole table
+// can be written out and read back (or mapped) as is.
+template<int N, class FK>
+class IKQuadLut
+{
+public:
+    IKQuadLut(const float ranges[][2], const float* radii, FK forwardSolve, float reqError) :
+        jointRanges(ranges),
+        jointRadii(radii),
+        fk(forwardSolve),
+        maxError(reqError),
+        depthLimit(0),
+        xLower(0.0f), yLower(0.0f),
+        xSize(0.0f), ySize(0.0f),
+        solveEngine(IK_ENGINE_DLS),
+        buildTolerance(0.0f),
+        buildWorkspace(0),
+        solves(0)
+    {
+    }
+
+    // Builds the tree over [lower, upper]. Corners are solved with engine to
+    // a quarter of tolerance, so refinement follows interpolation error
+    // rather than solver slack; lookups that can't be interpolated are later
+    // solved from scratch with the same engine. A workspace map, if given, prunes whole
+    // cells it can rule out without solving anything in them. Returns the
+    // number of solves spent.
+    int build(const Vector2d& lower, const Vector2d& upper, float tolerance, int maxDepth = QUAD_LUT_MAX_DEPTH, const IKWorkspace* workspace = 0, IKEngine engine = IK_ENGINE_DLS)
+    {
+        xLower = lower.x;
+        yLower = lower.y;
+        xSize = upper.x - lower.x;
+        ySize = upper.y - lower.y;
+        depthLimit = (maxDepth > 30) ? 30 : maxDepth;
+        buildTolerance = tolerance;
+        solveEngine = engine;
+        buildWorkspace = workspace;
+        solves = 0;
+        nodes.clear();
+        values.clear();
+        solved.clear();
+
+        nodes.push_back(0);
+        const uint32_t root = buildNode(0, 0, 0, 1u << depthLimit);
+        nodes[0] = root;
+        solved.clear();
+        return solves;
+    }
+
+    // Returns 0 if the angles were interpolated from the tree, the number of
+    // forward solves if the solver had to be used, or -1 if the target could
+    // not be reached.
+    int lookup(const Vector2d& target, float* angles)
+    {
+        float x0 = xLower, y0 = yLower, w = xSize, h = ySize;
+        if(nodes.empty() || target.x < x0 || target.y < y0 || target.x > x0 + w || target.y > y0 + h)
+        {
+            return solve<N>(angles, jointRanges, jointRadii, fk, target, maxError, solveEngine);
+        }
+        uint32_t node = nodes[0];
+        while(!(node & QUAD_LUT_LEAF))
+        {
+            w *= 0.5f;
+            h *= 0.5f;
+            int q = 0;
+            if(target.x >= x0 + w)
+            {
+                q |= 1;
+                x0 += w;
+            }
+            if(target.y >= y0 + h)
+            {
+                q |= 2;
+                y0 += h;
+            }
+            node = nodes[node + q];
+        }
+        if(node == QUAD_LUT_UNREACHABLE)
+        {
+            return -1;
+        }
+        if(node == QUAD_LUT_SOLVE)
+        {
+            return solve<N>(angles, jointRanges, jointRadii, fk, target, maxError, solveEngine);
+        }
+
+        const float* c = &values[(node & ~QUAD_LUT_LEAF)*4*N];
+        const float fx = (target.x - x0)/w;
+        const float fy = (target.y - y0)/h;
+        int seed = -1;
+        for(int corner = 0; corner < 4; corner++)
+        {
+            if(c[corner*N] == c[corner*N])
+            {
+                // Nearest solved corner, should the solver be needed
+                if(seed == -1 || cornerDistance(corner, fx, fy) < cornerDistance(seed, fx, fy))
+                {
+                    seed = corner;
+                }
+            }
+        }
+        if(seed != -1 && complete(c))
+        {
+            for(int k = 0; k < N; k++)
+            {
+                const float bottom = c[k] + (c[N + k] - c[k])*fx;
+                const float top = c[2*N + k] + (c[3*N + k] - c[2*N + k])*fx;
+                angles[k] = bottom + (top - bottom)*fy;
+            }
+            return 0;
+        }
+
+        // Partly solved leaf at the edge of the workspace
+        if(seed != -1)
+        {
+            for(int k = 0; k < N; k++)
+            {
+                angles[k] = c[seed*N + k];
+            }
+            int res = solveFrom<N>(angles, jointRanges, jointRadii, fk, target, maxError);
+            if(res != -1)
+            {
+                return res;
+            }
+        }
+        return solve<N>(angles, jointRanges, jointRadii, fk, target, maxError, solveEngine);
+    }
+
+    int nodeCount() const { return (int)nodes.size(); }
+    int leafCount() const { return (int)(values.size()/(4*N)); }
+    // Engine the tree was built with, which fallback solves use too
+    IKEngine engine() const { return solveEngine; }
+
+    // Bytes taken by the nodes and leaf values
+    size_t bytes() const { return nodes.size()*sizeof(uint32_t) + values.size()*sizeof(float); }
+
+    // Writes the tree next to path and renames it over path once it is on
+    // disk, so a crash or a concurrent load() never sees a partial file
+    bool save(const char* path, uint64_t geometryHash) const
+    {
+        IKQuadLutHeader header = makeHeader(geometryHash);
+        const std::string tmpPath = std::string(path) + ".tmp";
+        FILE* f = fopen(tmpPath.c_str(), "wb");
+        if(!f)
+        {
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+                  fwrite(&nodes[0], sizeof(uint32_t), nodes.size(), f) == nodes.size() &&
+                  (values.empty() || fwrite(&values[0], sizeof(float), values.size(), f) == values.size()) &&
+                  fflush(f) == 0 &&
+                  fsync(fileno(f)) == 0;
+        ok = (fclose(f) == 0) && ok && rename(tmpPath.c_str(), path) == 0;
+        if(!ok)
+        {
+            remove(tmpPath.c_str());
+        }
+        return ok;
+    }
+
+    // Reads a tree written by save(), checking it was built for N joints and
+    // (unless geometryHash is 0) the same geometry. Fallback solves then use
+    // the engine the tree was built with.
+    bool load(const char* path, uint64_t geometryHash)
+    {
+        FILE* f = fopen(path, "rb");
+        if(!f)
+        {
+            return false;
+        }
+        IKQuadLutHeader header;
+        bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+                  header.magic == QUAD_LUT_MAGIC && header.version == QUAD_LUT_VERSION &&
+                  header.checksum == lutChecksum(&header, offsetof(IKQuadLutHeader, checksum)) &&
+                  header.nJoints == (uint32_t)N && header.nodeCount > 0 &&
+                  (header.engine == IK_ENGINE_DESCENT || header.engine == IK_ENGINE_DLS) &&
+                  (geometryHash == 0 || header.geometryHash == geometryHash);
+        std::vector<uint32_t> newNodes(ok ? header.nodeCount : 0);
+        std::vector<float> newValues(ok ? header.valueCount : 0);
+        ok = ok && fread(&newNodes[0], sizeof(uint32_t), newNodes.size(), f) == newNodes.size() &&
+             (newValues.empty() || fread(&newValues[0], sizeof(float), newValues.size(), f) == newValues.size());
+        fclose(f);
+        if(!ok || header.dataChecksum != dataChecksum(newNodes, newValues) || !validNodes(newNodes, newValues))
+        {
+            return false;
+        }
+        nodes.swap(newNodes);
+        values.swap(newValues);
+        depthLimit = header.maxDepth;
+        xLower = header.xLower;
+        yLower = header.yLower;
+        xSize = header.xSize;
+        ySize = header.ySize;
+        solveEngine = (IKEngine)header.engine;
+        return true;
+    }
+
+private:
+    // Corner offsets in child order
+    static int cornerX(int corner) { return corner & 1; }
+    static int cornerY(int corner) { return corner >> 1; }
+
+    static float cornerDistance(int corner, float fx, float fy)
+    {
+        const float dx = fx - cornerX(corner), dy = fy - cornerY(corner);
+        return dx*dx + dy*dy;
+    }
+
+    static bool complete(const float* c)
+    {
+        for(int corner = 0; corner < 4; corner++)
+        {
+            if(c[corner*N] != c[corner*N])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Vector2d latticePoint(uint32_t ix, uint32_t iy) const
+    {
+        const float scale = 1.0f/(float)(1u << depthLimit);
+        return Vector2d(xLower + xSize*ix*scale, yLower + ySize*iy*scale);
+    }
+
+    // Angles solved at lattice point (ix, iy) (NaN if unreachable), solving
+    // each point only once
+    const float* solveAt(uint32_t ix, uint32_t iy)
+    {
+        const uint64_t key = ((uint64_t)ix << 32) | iy;
+        typename std::map<uint64_t, std::vector<float> >::iterator it = solved.find(key);
+        if(it != solved.end())
+        {
+            return &it->second[0];
+        }
+        std::vector<float>& a = solved[key];
+        a.assign(N, 0.0f);
+        const Vector2d target = latticePoint(ix, iy);
+        int res = -1;
+        if(!buildWorkspace || buildWorkspace->reachable(target, maxError))
+        {
+            res = solve<N>(&a[0], jointRanges, jointRadii, fk, target, buildTolerance*0.25f, solveEngine);
+            solves++;
+        }
+        if(res == -1)
+        {
+            a.assign(N, NAN);
+        }
+        return &a[0];
+    }
+
+    // Distance from target to the end effector at the angles interpolated
+    // from corners, or -1 if a corner is unsolved
+    float interpolationError(const float* const* corners, float fx, float fy, const Vector2d& target)
+    {
+        float angles[N];
+        for(int k = 0; k < N; k++)
+        {
+            const float bottom = corners[0][k] + (corners[1][k] - corners[0][k])*fx;
+            const float top = corners[2][k] + (corners[3][k] - corners[2][k])*fx;
+            angles[k] = bottom + (top - bottom)*fy;
+        }
+        return (fk(angles) - target).magnitude();
+    }
+
+    uint32_t buildNode(int depth, uint32_t ix, uint32_t iy, uint32_t size)
+    {
+        const Vector2d lo = latticePoint(ix, iy);
+        const Vector2d hi = latticePoint(ix + size, iy + size);
+        if(buildWorkspace)
+        {
+            // Nothing within reach anywhere in the cell
+            const Vector2d centre((lo.x + hi.x)*0.5f, (lo.y + hi.y)*0.5f);
+            const float halfDiagonal = 0.5f*std::sqrt((hi.x - lo.x)*(hi.x - lo.x) + (hi.y - lo.y)*(hi.y - lo.y));
+            if(buildWorkspace->distanceBound(centre) > halfDiagonal + maxError)
+            {
+                return QUAD_LUT_UNREACHABLE;
+            }
+        }
+
+        const float* corners[4];
+        int solvedCorners = 0;
+        for(int corner = 0; corner < 4; corner++)
+        {
+            corners[corner] = solveAt(ix + cornerX(corner)*size, iy + cornerY(corner)*size);
+            solvedCorners += (corners[corner][0] == corners[corner][0]) ? 1 : 0;
+        }
+
+        // Corners are solved more tightly than lookups need, so near the edge
+        // of the workspace a cell with no solved points may still hold
+        // targets within reqError. Only the workspace map can rule that out;
+        // without one such cells are taken to be unreachable.
+        const uint32_t empty = buildWorkspace ? QUAD_LUT_SOLVE : QUAD_LUT_UNREACHABLE;
+        if(depth == depthLimit)
+        {
+            return (solvedCorners == 0) ? empty : leaf(corners);
+        }
+
+        // Check the centre and edge midpoints against interpolation
+        bool split = (depth < QUAD_LUT_MIN_DEPTH) || (solvedCorners != 0 && solvedCorners != 4);
+        bool anySolved = (solvedCorners != 0);
+        const uint32_t half = size/2;
+        const uint32_t probes[5][2] = {{1, 1}, {1, 0}, {0, 1}, {2, 1}, {1, 2}};
+        for(int p = 0; p < 5 && !split; p++)
+        {
+            const float* a = solveAt(ix + probes[p][0]*half, iy + probes[p][1]*half);
+            const bool reachable = (a[0] == a[0]);
+            anySolved = anySolved || reachable;
+            if(solvedCorners == 4)
+            {
+                split = !reachable || interpolationError(corners, probes[p][0]*0.5f, probes[p][1]*0.5f, latticePoint(ix + probes[p][0]*half, iy + probes[p][1]*half)) > buildTolerance;
+            }
+            else
+            {
+                split = reachable;
+            }
+        }
+        if(!split)
+        {
+            return anySolved ? leaf(corners) : empty;
+        }
+
+        const uint32_t first = (uint32_t)nodes.size();
+        nodes.resize(nodes.size() + 4);
+        for(int q = 0; q < 4; q++)
+        {
+            const uint32_t child = buildNode(depth + 1, ix + cornerX(q)*half, iy + cornerY(q)*half, half);
+            nodes[first + q] = child;
+        }
+        return first;
+    }
+
+    uint32_t leaf(const float* const* corners)
+    {
+        const uint32_t index = (uint32_t)(values.size()/(4*N));
+        for(int corner = 0; corner < 4; corner++)
+        {
+            values.insert(values.end(), corners[corner], corners[corner] + N);
+        }
+        return QUAD_LUT_LEAF | index;
+    }
+
+    // Whether every child and leaf index of a loaded tree is in bounds, and
+    // every internal node's children come after it, so lookup() can't leave
+    // the arrays or loop
+    static bool validNodes(const std::vector<uint32_t>& n, const std::vector<float>& v)
+    {
+        if(v.size() % (4*N) != 0)
+        {
+            return false;
+        }
+        const size_t leaves = v.size()/(4*N);
+        for(size_t k = 0; k < n.size(); k++)
+        {
+            const uint32_t node = n[k];
+            if(node == QUAD_LUT_UNREACHABLE || node == QUAD_LUT_SOLVE)
+            {
+                continue;
+            }
+            if(node & QUAD_LUT_LEAF)
+            {
+                if((node & ~QUAD_LUT_LEAF) >= leaves)
+                {
+                    return false;
+                }
+            }
+            else if(node <= k || (size_t)node + 4 > n.size())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static uint64_t dataChecksum(const std::vector<uint32_t>& n, const std::vector<float>& v)
+    {
+        uint64_t hash = lutChecksum(&n[0], n.size()*sizeof(uint32_t));
+        return v.empty() ? hash : lutChecksum(&v[0], v.size()*sizeof(float), hash);
+    }
+
+    IKQuadLutHeader makeHeader(uint64_t geometryHash) const
+    {
+        IKQuadLutHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = QUAD_LUT_MAGIC;
+        header.version = QUAD_LUT_VERSION;
+        header.nJoints = N;
+        header.maxDepth = depthLimit;
+        header.xLower = xLower;
+        header.yLower = yLower;
+        header.xSize = xSize;
+        header.ySize = ySize;
+        header.nodeCount = (uint32_t)nodes.size();
+        header.valueCount = (uint32_t)values.size();
+        header.engine = solveEngine;
+        header.geometryHash = geometryHash;
+        header.dataChecksum = dataChecksum(nodes, values);
+        header.checksum = lutChecksum(&header, offsetof(IKQuadLutHeader, checksum));
+        return header;
+    }
+
+    const float (*jointRanges)[2];
+    const float* jointRadii;
+    FK fk;
+    float maxError;
+    int depthLimit;
+    float xLower, yLower;
+    float xSize, ySize;
+    std::vector<uint32_t> nodes;
+    std::vector<float> values;
+
+    // Also used for lookups that have to be solved from scratch
+    IKEngine solveEngine;
+
+    // Build state
+    float buildTolerance;
+    const IKWorkspace* buildWorkspace;
+    int solves;
+    std::map<uint64_t, std::vector<float> > solved;
+};
+
+// Deduces the forward kinematics type, e.g.
+// auto quad = makeQuadLut<2>(ranges, radii, [](float* a){ return ...; }, 1.0f);
+template<int N, class FK>
+inline IKQuadLut<N, FK> makeQuadLut(const float ranges[][2], const float* radii, FK forwardSolve, float reqError)
+{
+    return IKQuadLut<N, FK>(ranges, radii, forwardSolve, reqError);
+}
+
+#endif // _IK_QUAD_LUT_H_
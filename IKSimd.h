@@ -0,0 +1,176 @@
+/*
+ *     IKSimd.h
+ *
+ *     This file wraps the SIMD registers used by the batched solver.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_SIMD_H_
+#define _IK_SIMD_H_
+
+#include <cmath>
+
+// IKFloatV holds IK_SIMD_WIDTH floats (8 with AVX, 4 with SSE, 1 otherwise)
+// and IKMaskV holds one comparison result per lane.
+
+#if defined(__AVX__)
+
+#include <immintrin.h>
+
+#define IK_SIMD_WIDTH 8
+
+struct IKFloatV { __m256 v; };
+struct IKMaskV { __m256 v; };
+
+inline IKFloatV ikSet1(float a) { IKFloatV r = {_mm256_set1_ps(a)}; return r; }
+inline IKFloatV ikLoad(const float* p) { IKFloatV r = {_mm256_loadu_ps(p)}; return r; }
+inline void ikStore(float* p, const IKFloatV& a) { _mm256_storeu_ps(p, a.v); }
+
+inline IKFloatV operator+(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_add_ps(a.v, b.v)}; return r; }
+inline IKFloatV operator-(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_sub_ps(a.v, b.v)}; return r; }
+inline IKFloatV operator*(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_mul_ps(a.v, b.v)}; return r; }
+inline IKFloatV operator/(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_div_ps(a.v, b.v)}; return r; }
+inline IKFloatV ikSqrt(const IKFloatV& a) { IKFloatV r = {_mm256_sqrt_ps(a.v)}; return r; }
+inline IKFloatV ikMin(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_min_ps(a.v, b.v)}; return r; }
+inline IKFloatV ikMax(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_max_ps(a.v, b.v)}; return r; }
+
+inline IKMaskV ikLt(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; return r; }
+inline IKMaskV ikLe(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; return r; }
+inline IKMaskV ikEq(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)}; return r; }
+inline IKMaskV operator&(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {_mm256_and_ps(a.v, b.v)}; return r; }
+inline IKMaskV operator|(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {_mm256_or_ps(a.v, b.v)}; return r; }
+// a & ~b
+inline IKMaskV ikAndNot(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {_mm256_andnot_ps(b.v, a.v)}; return r; }
+inline IKMaskV ikMaskNone() { IKMaskV r = {_mm256_setzero_ps()}; return r; }
+inline int ikMaskBits(const IKMaskV& m) { return _mm256_movemask_ps(m.v); }
+// m ? a : b, lane by lane
+inline IKFloatV ikSelect(const IKMaskV& m, const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm256_blendv_ps(b.v, a.v, m.v)}; return r; }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+#define IK_SIMD_WIDTH 4
+
+struct IKFloatV { __m128 v; };
+struct IKMaskV { __m128 v; };
+
+inline IKFloatV ikSet1(float a) { IKFloatV r = {_mm_set1_ps(a)}; return r; }
+inline IKFloatV ikLoad(const float* p) { IKFloatV r = {_mm_loadu_ps(p)}; return r; }
+inline void ikStore(float* p, const IKFloatV& a) { _mm_storeu_ps(p, a.v); }
+
+inline IKFloatV operator+(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm_add_ps(a.v, b.v)}; return r; }
+inline IKFloatV operator-(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm_sub_ps(a.v, b.v)}; return r; }
+inline IKFloatV operator*(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm_mul_ps(a.v, b.v)}; return r; }
+inline IKFloatV operator/(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm_div_ps(a.v, b.v)}; return r; }
+inline IKFloatV ikSqrt(const IKFloatV& a) { IKFloatV r = {_mm_sqrt_ps(a.v)}; return r; }
+inline IKFloatV ikMin(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm_min_ps(a.v, b.v)}; return r; }
+inline IKFloatV ikMax(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {_mm_max_ps(a.v, b.v)}; return r; }
+
+inline IKMaskV ikLt(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {_mm_cmplt_ps(a.v, b.v)}; return r; }
+inline IKMaskV ikLe(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {_mm_cmple_ps(a.v, b.v)}; return r; }
+inline IKMaskV ikEq(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {_mm_cmpeq_ps(a.v, b.v)}; return r; }
+inline IKMaskV operator&(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {_mm_and_ps(a.v, b.v)}; return r; }
+inline IKMaskV operator|(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {_mm_or_ps(a.v, b.v)}; return r; }
+// a & ~b
+inline IKMaskV ikAndNot(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {_mm_andnot_ps(b.v, a.v)}; return r; }
+inline IKMaskV ikMaskNone() { IKMaskV r = {_mm_setzero_ps()}; return r; }
+inline int ikMaskBits(const IKMaskV& m) { return _mm_movemask_ps(m.v); }
+// m ? a : b, lane by lane (SSE2 has no blend instruction)
+inline IKFloatV ikSelect(const IKMaskV& m, const IKFloatV& a, const IKFloatV& b)
+{
+    IKFloatV r = {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))};
+    return r;
+}
+
+#else
+
+#define IK_SIMD_WIDTH 1
+
+struct IKFloatV { float v; };
+struct IKMaskV { bool v; };
+
+inline IKFloatV ikSet1(float a) { IKFloatV r = {a}; return r; }
+inline IKFloatV ikLoad(const float* p) { IKFloatV r = {*p}; return r; }
+inline void ikStore(float* p, const IKFloatV& a) { *p = a.v; }
+
+inline IKFloatV operator+(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {a.v + b.v}; return r; }
+inline IKFloatV operator-(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {a.v - b.v}; return r; }
+inline IKFloatV operator*(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {a.v * b.v}; return r; }
+inline IKFloatV operator/(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {a.v / b.v}; return r; }
+inline IKFloatV ikSqrt(const IKFloatV& a) { IKFloatV r = {std::sqrt(a.v)}; return r; }
+inline IKFloatV ikMin(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {(b.v < a.v) ? b.v : a.v}; return r; }
+inline IKFloatV ikMax(const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {(b.v > a.v) ? b.v : a.v}; return r; }
+
+inline IKMaskV ikLt(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {a.v < b.v}; return r; }
+inline IKMaskV ikLe(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {a.v <= b.v}; return r; }
+inline IKMaskV ikEq(const IKFloatV& a, const IKFloatV& b) { IKMaskV r = {a.v == b.v}; return r; }
+inline IKMaskV operator&(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {a.v && b.v}; return r; }
+inline IKMaskV operator|(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {a.v || b.v}; return r; }
+// a & ~b
+inline IKMaskV ikAndNot(const IKMaskV& a, const IKMaskV& b) { IKMaskV r = {a.v && !b.v}; return r; }
+inline IKMaskV ikMaskNone() { IKMaskV r = {false}; return r; }
+inline int ikMaskBits(const IKMaskV& m) { return m.v ? 1 : 0; }
+// m ? a : b, lane by lane
+inline IKFloatV ikSelect(const IKMaskV& m, const IKFloatV& a, const IKFloatV& b) { IKFloatV r = {m.v ? a.v : b.v}; return r; }
+
+#endif
+
+inline bool ikAny(const IKMaskV& m) { return ikMaskBits(m) != 0; }
+
+// Cody-Waite split of pi/2: the first two parts have few enough mantissa
+// bits that k*part is exact for the k reached by joint angles
+#define IK_SINCOS_PIO2_1 1.5703125f
+#define IK_SINCOS_PIO2_2 4.837512969970703125e-4f
+#define IK_SINCOS_PIO2_3 7.54978995489188216e-8f
+// Adding and subtracting 1.5*2^23 rounds a float to the nearest integer
+#define IK_SINCOS_ROUND 12582912.0f
+
+// Rounds every lane to the nearest integer; valid for |a| < 2^22
+inline IKFloatV ikRound(const IKFloatV& a)
+{
+    return (a + ikSet1(IK_SINCOS_ROUND)) - ikSet1(IK_SINCOS_ROUND);
+}
+
+// Sine and cosine of every lane, to within 1e-7 of the exact values for
+// |a| < 1e4. The angle is reduced to r in [-pi/4, pi/4] and quadrant k mod 4,
+// the sinf/cosf polynomials from Cephes are evaluated on r, and the results
+// are swapped and negated by quadrant, all without leaving the registers.
+inline void ikSinCos(const IKFloatV& a, IKFloatV& s, IKFloatV& c)
+{
+    const IKFloatV k = ikRound(a*ikSet1(0.63661977236758134f));
+    const IKFloatV r = ((a - k*ikSet1(IK_SINCOS_PIO2_1)) - k*ikSet1(IK_SINCOS_PIO2_2)) - k*ikSet1(IK_SINCOS_PIO2_3);
+    const IKFloatV r2 = r*r;
+    const IKFloatV sr = r + r*r2*(ikSet1(-1.6666654611e-1f) + r2*(ikSet1(8.3321608736e-3f) + r2*ikSet1(-1.9515295891e-4f)));
+    const IKFloatV cr = ikSet1(1.0f) - ikSet1(0.5f)*r2 + r2*r2*(ikSet1(4.166664568298827e-2f) + r2*(ikSet1(-1.388731625493765e-3f) + r2*ikSet1(2.443315711809948e-5f)));
+
+    // q = k mod 4, in [0, 4)
+    IKFloatV quarter = ikRound(k*ikSet1(0.25f));
+    quarter = ikSelect(ikLt(k*ikSet1(0.25f), quarter), quarter - ikSet1(1.0f), quarter);
+    const IKFloatV q = k - quarter*ikSet1(4.0f);
+    const IKMaskV odd = ikEq(q, ikSet1(1.0f)) | ikEq(q, ikSet1(3.0f));
+    const IKMaskV negSin = ikLe(ikSet1(2.0f), q);
+    const IKMaskV negCos = ikEq(q, ikSet1(1.0f)) | ikEq(q, ikSet1(2.0f));
+    const IKFloatV zero = ikSet1(0.0f);
+    s = ikSelect(odd, cr, sr);
+    c = ikSelect(odd, sr, cr);
+    s = ikSelect(negSin, zero - s, s);
+    c = ikSelect(negCos, zero - c, c);
+}
+
+#endif // _IK_SIMD_H_
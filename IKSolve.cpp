@@ -25,203 +25,56 @@
 
 using namespace std;
 
-//int16_t sin_lookup_table[] = {
-//    +0,  -1607,  -3211,  -4808,  -6392,  -7961,  -9512, -11039,
-//-12539, -14010, -15446, -16846, -18204, -19519, -20787, -22005,
-//-23170, -24279, -25330, -26319, -27245, -28106, -28898, -29621,
-//-30273, -30852, -31357, -31785, -32138, -32413, -32610, -32728,
-//-32768, -32728, -32610, -32413, -32138, -31785, -31357, -30852,
-//-30273, -29621, -28898, -28106, -27245, -26319, -25330, -24279,
-//-23170, -22005, -20787, -19519, -18204, -16846, -15446, -14010,
-//-12539, -11039,  -9512,  -7961,  -6392,  -4808,  -3211,  -1607,
-//    +0,  +1607,  +3211,  +4808,  +6392,  +7961,  +9512, +11039,
-//+12539, +14010, +15446, +16846, +18204, +19519, +20787, +22005,
-//+23170, +24279, +25330, +26319, +27245, +28106, +28898, +29621,
-//+30273, +30852, +31357, +31785, +32138, +32413, +32610, +32728,
-//+32767, +32728, +32610, +32413, +32138, +31785, +31357, +30852,
-//+30273, +29621, +28898, +28106, +27245, +26319, +25330, +24279,
-//+23170, +22005, +20787, +19519, +18204, +16846, +15446, +14010,
-//+12539, +11039,  +9512,  +7961,  +6392,  +4808,  +3211, 1607
-//};
-
-#define LERP_STEP 0.001f
-#define TIMEOUT 5000
+// sin(k*PI/512)*TrigLUTMagnitude for k = 0..256, padded with one extra
+// entry so the interpolation in quarterSinLUT() can always read seg + 1
+const int16_t sin_lookup_table[TrigLUTSegments + 2] = {
+         0,    201,    402,    603,    804,   1005,   1206,   1407,
+      1608,   1809,   2009,   2210,   2410,   2611,   2811,   3012,
+      3212,   3412,   3612,   3811,   4011,   4210,   4410,   4609,
+      4808,   5007,   5205,   5404,   5602,   5800,   5998,   6195,
+      6393,   6590,   6786,   6983,   7179,   7375,   7571,   7767,
+      7962,   8157,   8351,   8545,   8739,   8933,   9126,   9319,
+      9512,   9704,   9896,  10087,  10278,  10469,  10659,  10849,
+     11039,  11228,  11417,  11605,  11793,  11980,  12167,  12353,
+     12539,  12725,  12910,  13094,  13279,  13462,  13645,  13828,
+     14010,  14191,  14372,  14553,  14732,  14912,  15090,  15269,
+     15446,  15623,  15800,  15976,  16151,  16325,  16499,  16673,
+     16846,  17018,  17189,  17360,  17530,  17700,  17869,  18037,
+     18204,  18371,  18537,  18703,  18868,  19032,  19195,  19357,
+     19519,  19680,  19841,  20000,  20159,  20317,  20475,  20631,
+     20787,  20942,  21096,  21250,  21403,  21554,  21705,  21856,
+     22005,  22154,  22301,  22448,  22594,  22739,  22884,  23027,
+     23170,  23311,  23452,  23592,  23731,  23870,  24007,  24143,
+     24279,  24413,  24547,  24680,  24811,  24942,  25072,  25201,
+     25329,  25456,  25582,  25708,  25832,  25955,  26077,  26198,
+     26319,  26438,  26556,  26674,  26790,  26905,  27019,  27133,
+     27245,  27356,  27466,  27575,  27683,  27790,  27896,  28001,
+     28105,  28208,  28310,  28411,  28510,  28609,  28706,  28803,
+     28898,  28992,  29085,  29177,  29268,  29358,  29447,  29534,
+     29621,  29706,  29791,  29874,  29956,  30037,  30117,  30195,
+     30273,  30349,  30424,  30498,  30571,  30643,  30714,  30783,
+     30852,  30919,  30985,  31050,  31113,  31176,  31237,  31297,
+     31356,  31414,  31470,  31526,  31580,  31633,  31685,  31736,
+     31785,  31833,  31880,  31926,  31971,  32014,  32057,  32098,
+     32137,  32176,  32213,  32250,  32285,  32318,  32351,  32382,
+     32412,  32441,  32469,  32495,  32521,  32545,  32567,  32589,
+     32609,  32628,  32646,  32663,  32678,  32692,  32705,  32717,
+     32728,  32737,  32745,  32752,  32757,  32761,  32765,  32766,
+     32767,  32767
+};
 
 int solve(float* angles, const float ranges[][2], const float* radii, const int& nJoints, Vector2d (*forwardSolve)(float*), const Vector2d& target, const float& reqError)
 {
-    int solve_counter = 0;
-    Vector2d startPos = forwardSolve(angles);
-    Vector2d curPos, step, testPos;
-    int i = 0;
-    float dTheta = 0;
-    float error = 0;
-    float prevAngle = 0;
-    for(int j = 0; j < nJoints; j++)
-    {
-        angles[j] = 0.0f;//(ranges[i][0] + ranges[i][1])/2.0f;
-    }
-    for(float lerp_pos = LERP_STEP; lerp_pos <= 1.0f; lerp_pos+=LERP_STEP)
-    {
-        do
-        {
-            if(solve_counter >= TIMEOUT)
-            {
-                //cout << "<" << target.x << ", " << target.y << ">\t";
-                break;
-            }
-            // Forward solve for the current end effector position
-            curPos = forwardSolve(angles);
-            solve_counter++;
-            // Calculate the next small step to the target position
-            step = startPos.lerp(target, lerp_pos);
-            // Compute the error (distance between current end effector position and
-            // the step position)
-            error = (curPos-step).magnitude();
-
-            // Compute the dtheta
-            dTheta = error/radii[i];
-
-            // Test dtheta in the positive direction
-            prevAngle = angles[i];
-
-            angles[i] = prevAngle + dTheta;
-            if(angles[i] > ranges[i][1])
-            {
-                angles[i] = ranges[i][1];
-            }
-
-            // Forward solve again
-            testPos = forwardSolve(angles);
-            solve_counter++;
-            // Did the +dtheta result in a position closer to the target?
-            if((testPos-step).magnitude() < error)
-            {
-                // Yes, proceed to next loop iteration
-                continue;
-            }
-            // No, try the other direction
-            else
-            {
-                // Test -dtheta
-                angles[i] = prevAngle - dTheta;
-                if(angles[i] < ranges[i][0])
-                {
-                    angles[i] = ranges[i][0];
-                }
-                // Forward solve again
-                testPos = forwardSolve(angles);
-                solve_counter++;
-                if((testPos-step).magnitude() < error)
-                {
-                    continue;
-                }
-            }
-            angles[i] = prevAngle;
-
-
-            i++;
-            if(i == nJoints)
-            {
-                i = 0;
-            }
-
-
-        }
-        while(error > reqError);
-        if(solve_counter >= TIMEOUT)
-        {
-            break;
-
-        }
-    }
-    return (solve_counter >= TIMEOUT)?(-1):(solve_counter);
+    return solveImpl<0>(angles, ranges, radii, nJoints, forwardSolve, target, reqError);
 }
 
-//#define I_LERP_STEPS        (8)
-//#define I_LERP_T_MAX        (128)
-//#define I_LERP_STEP         (I_LERP_T_MAX/I_LERP_STEPS)
-//
-//template<class A, class B, class T>
-//inline int_fast32_t i_lerp(A a, B b, T t)
-//{
-//    //return ((b-a)*((8<<sizeof(t))-1))/t;
-//    return a + (((b-a)*t)/I_LERP_T_MAX);
-//}
-//
-//
-//
-//int_fast32_t solve(int_fast32_t* angles,
-//          const int_fast32_t* radii,
-//          const int_fast8_t& nJoints,
-//          void (*forwardSolve)(int_fast32_t*, vector_int_2d_t&),
-//          vector_int_2d_t target,
-//          const int_fast32_t& reqError)
-//{
-//    int_fast32_t solve_counter = 0;
-//    vector_int_2d_t startPos, step, testPos;
-//    forwardSolve(angles, startPos);
-//
-//    // Premultiply to match magnitude returned by forwardSolve
-//    target.x *= TrigLUTMagnitude;
-//    target.y *= TrigLUTMagnitude;
-//
-//    int i = 0;
-//    int_fast32_t error, prevAngle;
-//    // Fix for loop breaking out after lerp_pos = 112
-//    for(int8_t lerp_pos = I_LERP_STEP; lerp_pos <= I_LERP_T_MAX; lerp_pos+=I_LERP_STEP)
-//    {
-//        // Calculate the next small step to the target position
-//        step.x = i_lerp<int_fast32_t, int_fast32_t, int8_t>(startPos.x, target.x, lerp_pos);
-//        step.y = i_lerp<int_fast32_t, int_fast32_t, int8_t>(startPos.y, target.y, lerp_pos);
-//        do
-//        {
-//            // Forward solve for the current end effector position
-//            forwardSolve(angles, testPos);
-//            solve_counter++;
-//
-//            // Compute the error (distance between current end effector position and
-//            // the step position)
-//            error = abs(step.x-testPos.x) + abs(step.y-testPos.y);
-//
-//            // Compute the dtheta
-//            //dTheta = error/radii[i];
-//
-//            // Test dtheta in the positive direction
-//            prevAngle = angles[i];
-//            angles[i] = (prevAngle*radii[i]*TrigLUTMagnitude + (error*TrigLUTTwoPiRatio))/(radii[i]*TrigLUTMagnitude);
-//
-//            // Forward solve again
-//            forwardSolve(angles, testPos);
-//            solve_counter++;
-//            // Did the +dtheta result in a position closer to the target?
-//            if((abs(step.x-testPos.x) + abs(step.y-testPos.y)) < error)
-//            {
-//                // Yes, proceed to next loop iteration
-//                continue;
-//            }
-//            // No, try the other direction
-//            else
-//            {
-//                // Test -dtheta (need to subtract 2*dtheta to cancel the +dtheta from before)
-//                angles[i] = (prevAngle*radii[i]*TrigLUTMagnitude - (error*TrigLUTTwoPiRatio))/(radii[i]*TrigLUTMagnitude);
-//                // Forward solve again
-//                forwardSolve(angles, testPos);
-//                solve_counter++;
-//                if((abs(step.x-testPos.x) + abs(step.y-testPos.y)) < error)
-//                {
-//                    continue;
-//                }
-//            }
-//            angles[i] = prevAngle;
-//
-//
-//            i++;
-//            if(i == nJoints)
-//            {
-//                i = 0;
-//            }
-//        }
-//        while(error > reqError);
-//    }
-//    return solve_counter;
-//}
+int_fast32_t solve(int_fast32_t* angles,
+          const int_fast32_t ranges[][2],
+          const int_fast32_t* radii,
+          const int_fast8_t& nJoints,
+          void (*forwardSolve)(int_fast32_t*, vector_int_2d_t&),
+          vector_int_2d_t target,
+          const int_fast32_t& reqError)
+{
+    return solveFixedImpl<0>(angles, ranges, radii, nJoints, forwardSolve, target, reqError);
+}
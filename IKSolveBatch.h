@@ -0,0 +1,207 @@
+/*
+ *     IKSolveBatch.h
+ *
+ *     This file implements the batched (SIMD) IK solver.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_SOLVE_BATCH_H_
+#define _IK_SOLVE_BATCH_H_
+
+#include "IKSolve.h"
+#include "IKSimd.h"
+
+// Runs the coordinate descent of solve() on IK_SIMD_WIDTH targets at once.
+// Every lane keeps its own joint index, lerp position and evaluation count;
+// lanes that have converged or timed out are masked off until the whole
+// register is done.
+//
+// The data is in structure-of-arrays form: angles[j][k] is joint j of target
+// k, and is used both as the start pose and to return the solution, just like
+// the angles argument of solve(). results[k] receives the evaluation count,
+// or -1 on timeout.
+//
+// FKV is the vectorized forward kinematics, called as
+// forwardSolve(const IKFloatV* angles, IKFloatV& x, IKFloatV& y).
+template<int N, class FKV>
+inline void solveBatchLanes(IKFloatV* angles, const float ranges[][2], const float* radii, FKV& forwardSolve, const IKFloatV& targetX, const IKFloatV& targetY, const float reqError, IKMaskV active, IKFloatV& counter, IKMaskV& timedOut)
+{
+    const IKFloatV one = ikSet1(1.0f);
+    const IKFloatV zero = ikSet1(0.0f);
+    const IKFloatV lerpStep = ikSet1(IK_LERP_STEP);
+    const IKFloatV timeout = ikSet1((float)IK_TIMEOUT);
+    const IKFloatV maxError = ikSet1(reqError);
+
+    IKFloatV startX, startY;
+    forwardSolve(angles, startX, startY);
+    for(int j = 0; j < N; j++)
+    {
+        angles[j] = zero;
+    }
+
+    IKFloatV lerpPos = lerpStep;
+    IKFloatV joint = zero;
+    counter = zero;
+    timedOut = ikMaskNone();
+
+    IKFloatV curX, curY, testX, testY, dx, dy;
+    while(ikAny(active))
+    {
+        // Forward solve for the current end effector position
+        forwardSolve(angles, curX, curY);
+        counter = ikSelect(active, counter + one, counter);
+
+        // Calculate the next small step to the target position
+        IKFloatV stepX = startX + (targetX - startX)*lerpPos;
+        IKFloatV stepY = startY + (targetY - startY)*lerpPos;
+        dx = curX - stepX;
+        dy = curY - stepY;
+        IKFloatV error = ikSqrt(dx*dx + dy*dy);
+
+        // Gather the per lane joint parameters
+        IKMaskV isJoint[N];
+        IKFloatV radius = one, lower = zero, upper = zero, prevAngle = zero;
+        for(int j = 0; j < N; j++)
+        {
+            isJoint[j] = ikEq(joint, ikSet1((float)j));
+            radius = ikSelect(isJoint[j], ikSet1(radii[j]), radius);
+            lower = ikSelect(isJoint[j], ikSet1(ranges[j][0]), lower);
+            upper = ikSelect(isJoint[j], ikSet1(ranges[j][1]), upper);
+            prevAngle = ikSelect(isJoint[j], angles[j], prevAngle);
+        }
+        IKFloatV dTheta = error/radius;
+
+        // Test dtheta in the positive direction
+        IKFloatV testAngle = ikMin(prevAngle + dTheta, upper);
+        for(int j = 0; j < N; j++)
+        {
+            angles[j] = ikSelect(isJoint[j] & active, testAngle, angles[j]);
+        }
+        forwardSolve(angles, testX, testY);
+        counter = ikSelect(active, counter + one, counter);
+        dx = testX - stepX;
+        dy = testY - stepY;
+        IKMaskV accepted = active & ikLt(ikSqrt(dx*dx + dy*dy), error);
+
+        // Test -dtheta on the lanes that did not improve
+        IKMaskV retry = ikAndNot(active, accepted);
+        if(ikAny(retry))
+        {
+            testAngle = ikMax(prevAngle - dTheta, lower);
+            for(int j = 0; j < N; j++)
+            {
+                angles[j] = ikSelect(isJoint[j] & retry, testAngle, angles[j]);
+            }
+            forwardSolve(angles, testX, testY);
+            counter = ikSelect(retry, counter + one, counter);
+            dx = testX - stepX;
+            dy = testY - stepY;
+            accepted = accepted | (retry & ikLt(ikSqrt(dx*dx + dy*dy), error));
+        }
+
+        // Lanes that improved in neither direction restore the joint and move
+        // on to the next one
+        IKMaskV rejected = ikAndNot(active, accepted);
+        for(int j = 0; j < N; j++)
+        {
+            angles[j] = ikSelect(isJoint[j] & rejected, prevAngle, angles[j]);
+        }
+        joint = ikSelect(rejected, joint + one, joint);
+        joint = ikSelect(ikEq(joint, ikSet1((float)N)), zero, joint);
+
+        // Out of evaluations?
+        IKMaskV expired = active & ikLe(timeout, counter);
+        timedOut = timedOut | expired;
+        active = ikAndNot(active, expired);
+
+        // Close enough to the intermediate target, advance the lerp
+        IKMaskV reached = active & ikLe(error, maxError);
+        lerpPos = ikSelect(reached, lerpPos + lerpStep, lerpPos);
+        active = ikAndNot(active, reached & ikLt(one, lerpPos));
+    }
+}
+
+// Solves count targets, IK_SIMD_WIDTH at a time. See solveBatchLanes() for the
+// data layout; the final partial register is padded with masked off lanes.
+// Targets a workspace map rejects get -1 without taking up a lane, and their
+// angles are left as they were.
+template<int N, class FKV>
+void solveBatch(float* const* angles, const float ranges[][2], const float* radii, FKV forwardSolve, const float* targetX, const float* targetY, int count, const float& reqError, int* results, const IKWorkspace* workspace = 0)
+{
+    float laneBuf[N + 3][IK_SIMD_WIDTH];
+    float timedOutBuf[IK_SIMD_WIDTH];
+    IKFloatV laneAngles[N];
+    int source[IK_SIMD_WIDTH];
+    int next = 0;
+    while(next < count)
+    {
+        // Gather the next IK_SIMD_WIDTH targets worth solving
+        int lanes = 0;
+        while(lanes < IK_SIMD_WIDTH && next < count)
+        {
+            if(workspace && !workspace->reachable(Vector2d(targetX[next], targetY[next]), reqError))
+            {
+                results[next++] = -1;
+                continue;
+            }
+            source[lanes++] = next++;
+        }
+        if(lanes == 0)
+        {
+            break;
+        }
+
+        for(int k = 0; k < IK_SIMD_WIDTH; k++)
+        {
+            // Pad with copies of the first lane so the padding stays finite
+            int src = source[(k < lanes) ? k : 0];
+            for(int j = 0; j < N; j++)
+            {
+                laneBuf[j][k] = angles[j][src];
+            }
+            laneBuf[N][k] = targetX[src];
+            laneBuf[N + 1][k] = targetY[src];
+            laneBuf[N + 2][k] = (k < lanes) ? 1.0f : 0.0f;
+        }
+        for(int j = 0; j < N; j++)
+        {
+            laneAngles[j] = ikLoad(laneBuf[j]);
+        }
+        IKMaskV active = ikLt(ikSet1(0.5f), ikLoad(laneBuf[N + 2]));
+        IKFloatV counter;
+        IKMaskV timedOut;
+        solveBatchLanes<N>(laneAngles, ranges, radii, forwardSolve, ikLoad(laneBuf[N]), ikLoad(laneBuf[N + 1]), reqError, active, counter, timedOut);
+
+        for(int j = 0; j < N; j++)
+        {
+            ikStore(laneBuf[j], laneAngles[j]);
+        }
+        ikStore(laneBuf[N], counter);
+        ikStore(timedOutBuf, ikSelect(timedOut, ikSet1(1.0f), ikSet1(0.0f)));
+        for(int k = 0; k < lanes; k++)
+        {
+            for(int j = 0; j < N; j++)
+            {
+                angles[j][source[k]] = laneBuf[j][k];
+            }
+            results[source[k]] = (timedOutBuf[k] != 0.0f) ? -1 : (int)laneBuf[N][k];
+        }
+    }
+}
+
+#endif // _IK_SOLVE_BATCH_H_
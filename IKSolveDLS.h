@@ -0,0 +1,210 @@
+/*
+ *     IKSolveDLS.h
+ *
+ *     This file implements the damped least squares (Levenberg-Marquardt)
+ *     IK solver.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_SOLVE_DLS_H_
+#define _IK_SOLVE_DLS_H_
+
+#include "IKFastTrig.h"
+#include "VectorLib/Vector.h"
+
+// Initial damping, in units of length
+#define DLS_LAMBDA 1.0f
+// Damping beyond which the target is considered out of reach
+#define DLS_LAMBDA_MAX 1.0e4f
+// Joint perturbation used for finite difference Jacobians, in radians
+#define DLS_FD_STEP 0.001f
+#define DLS_TIMEOUT 500
+
+// Jacobian of the end effector position by finite differences of the forward
+// kinematics. Costs N forward solves; joints at their upper limit are
+// differenced backwards so the perturbed pose stays inside ranges.
+template<int N, class FK>
+struct IKFiniteDifferenceJacobian
+{
+    FK& forwardSolve;
+    const float (*ranges)[2];
+
+    template<class VEC>
+    IK_CONSTEXPR14 int operator()(float* angles, const VEC& pos, float J[2][N])
+    {
+        for(int j = 0; j < N; j++)
+        {
+            const float prevAngle = angles[j];
+            const float h = (prevAngle + DLS_FD_STEP > ranges[j][1]) ? -DLS_FD_STEP : DLS_FD_STEP;
+            angles[j] = prevAngle + h;
+            const VEC testPos = forwardSolve(angles);
+            angles[j] = prevAngle;
+            J[0][j] = (testPos.x - pos.x)/h;
+            J[1][j] = (testPos.y - pos.y)/h;
+        }
+        return N;
+    }
+};
+
+// Adapts a user supplied jacobian(const float* angles, float J[2][N]) to the
+// interface above. Costs no forward solves.
+template<int N, class JAC>
+struct IKAnalyticJacobian
+{
+    JAC& jacobian;
+
+    template<class VEC>
+    int operator()(float* angles, const VEC&, float J[2][N])
+    {
+        jacobian(angles, J);
+        return 0;
+    }
+};
+
+// Levenberg-Marquardt iteration on the 2xN Jacobian. Each step solves
+// (J*J' + lambda^2*I)*y = e and moves the joints by J'*y, clamped to ranges;
+// joints pinned at a limit and pushed further into it are dropped from the
+// step. Accepted steps halve lambda, rejected ones quadruple it. Starts from
+// the zero pose like solve(), and returns the number of forward solves (the
+// Jacobian's included) or -1 if the target could not be reached.
+//
+// VEC is the position type forwardSolve returns: Vector2d, or IKVec2C when
+// solveDLSConstexpr() runs this at compile time.
+template<int N, class FK, class JAC, class VEC>
+IK_CONSTEXPR14 int solveDLSImpl(float* angles, const float ranges[][2], FK& forwardSolve, JAC& jacobian, const VEC& target, const float reqError)
+{
+    float J[2][N] = {};
+    float newAngles[N] = {};
+    float dTheta[N] = {};
+    bool pinned[N] = {};
+    for(int j = 0; j < N; j++)
+    {
+        angles[j] = 0.0f;
+    }
+
+    int solve_counter = 1;
+    VEC curPos = forwardSolve(angles);
+    float error = (target-curPos).magnitude();
+    float lambda = DLS_LAMBDA;
+    bool needJacobian = true;
+
+    while(error > reqError)
+    {
+        if(solve_counter >= DLS_TIMEOUT || lambda > DLS_LAMBDA_MAX)
+        {
+            return -1;
+        }
+        if(needJacobian)
+        {
+            solve_counter += jacobian(angles, curPos, J);
+            needJacobian = false;
+        }
+
+        const float ex = target.x - curPos.x;
+        const float ey = target.y - curPos.y;
+        for(int j = 0; j < N; j++)
+        {
+            pinned[j] = false;
+        }
+        // At most one pass to drop joints pushed into their limits
+        for(int pass = 0; pass < 2; pass++)
+        {
+            float a = lambda*lambda, b = 0.0f, d = lambda*lambda;
+            for(int j = 0; j < N; j++)
+            {
+                if(!pinned[j])
+                {
+                    a += J[0][j]*J[0][j];
+                    b += J[0][j]*J[1][j];
+                    d += J[1][j]*J[1][j];
+                }
+            }
+            const float det = a*d - b*b;
+            const float yx = (d*ex - b*ey)/det;
+            const float yy = (a*ey - b*ex)/det;
+
+            bool repin = false;
+            for(int j = 0; j < N; j++)
+            {
+                dTheta[j] = pinned[j] ? 0.0f : (J[0][j]*yx + J[1][j]*yy);
+                if(!pinned[j] && ((angles[j] >= ranges[j][1] && dTheta[j] > 0.0f) ||
+                                  (angles[j] <= ranges[j][0] && dTheta[j] < 0.0f)))
+                {
+                    pinned[j] = true;
+                    repin = true;
+                }
+            }
+            if(!repin)
+            {
+                break;
+            }
+        }
+
+        for(int j = 0; j < N; j++)
+        {
+            newAngles[j] = angles[j] + dTheta[j];
+            if(newAngles[j] > ranges[j][1])
+            {
+                newAngles[j] = ranges[j][1];
+            }
+            if(newAngles[j] < ranges[j][0])
+            {
+                newAngles[j] = ranges[j][0];
+            }
+        }
+
+        const VEC testPos = forwardSolve(newAngles);
+        solve_counter++;
+        const float testError = (target-testPos).magnitude();
+        if(testError < error)
+        {
+            for(int j = 0; j < N; j++)
+            {
+                angles[j] = newAngles[j];
+            }
+            curPos = testPos;
+            error = testError;
+            lambda *= 0.5f;
+            needJacobian = true;
+        }
+        else
+        {
+            lambda *= 4.0f;
+        }
+    }
+    return solve_counter;
+}
+
+// Damped least squares solve with a finite difference Jacobian
+template<int N, class FK>
+inline int solveDLS(float* angles, const float ranges[][2], FK forwardSolve, const Vector2d& target, const float& reqError)
+{
+    IKFiniteDifferenceJacobian<N, FK> jacobian = {forwardSolve, ranges};
+    return solveDLSImpl<N>(angles, ranges, forwardSolve, jacobian, target, reqError);
+}
+
+// Damped least squares solve with an analytic Jacobian, called as
+// jacobian(const float* angles, float J[2][N])
+template<int N, class FK, class JAC>
+inline int solveDLS(float* angles, const float ranges[][2], FK forwardSolve, JAC jacobian, const Vector2d& target, const float& reqError)
+{
+    IKAnalyticJacobian<N, JAC> analytic = {jacobian};
+    return solveDLSImpl<N>(angles, ranges, forwardSolve, analytic, target, reqError);
+}
+
+#endif // _IK_SOLVE_DLS_H_
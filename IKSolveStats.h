@@ -0,0 +1,275 @@
+/*
+ *     IKSolveStats.h
+ *
+ *     This file declares the diagnostics the coordinate descent solver can
+ *     record about a solve.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_SOLVE_STATS_H_
+#define _IK_SOLVE_STATS_H_
+
+// Joints beyond this are folded into the last slot
+#define STATS_MAX_JOINTS 8
+// The lerp from start to target is split into this many phases
+#define STATS_LERP_PHASES 10
+// Consecutive clamped steps (per joint) that mean the solve is stuck at a limit
+#define STATS_STUCK_STEPS 4
+// Consecutive accepted steps reversing direction that mean it is oscillating
+#define STATS_OSCILLATION_STEPS 8
+
+enum IKStopReason
+{
+    IK_STOP_CONVERGED,
+    // Ran out of evaluations while still making progress
+    IK_STOP_TIMEOUT,
+    // Ran out of evaluations with a joint's recent steps pinned at its limit
+    IK_STOP_JOINT_LIMIT,
+    // Ran out of evaluations flipping between +dTheta and -dTheta
+    IK_STOP_OSCILLATING,
+    // Turned away before solving by the workspace check
+    IK_STOP_UNREACHABLE,
+    IK_STOP_REASONS
+};
+
+// The solver reports to a STATS policy through the calls below. IKNoStats
+// implements them as empty inlines, so a solve without diagnostics compiles
+// to exactly the uninstrumented loop.
+struct IKNoStats
+{
+    static const bool enabled = false;
+
+    void begin() {}
+    void evaluation(float) {}
+    void clamp(int) {}
+    void step(int, int) {}
+    void finish(bool, float) {}
+    void unreachable(float) {}
+};
+
+// Counts the descent's forward solves through the hooks, e.g. for forward
+// kinematics (like IKChain) that can't count their own calls
+struct IKEvaluationCounter : IKNoStats
+{
+    IKEvaluationCounter() : evaluations(0) {}
+
+    void evaluation(float) { evaluations++; }
+
+    long long evaluations;
+};
+
+// Records what happened during one solve. Attach a hook to see every solve
+// as it finishes, e.g. to aggregate an IKStatsHistogram.
+struct IKSolveStats
+{
+    static const bool enabled = true;
+
+    IKSolveStats() : hook(0), hookData(0)
+    {
+        begin();
+    }
+
+    // Forward solves in each lerp phase, and in total
+    int phaseEvaluations[STATS_LERP_PHASES];
+    int evaluations;
+    // Per joint: steps accepted in each direction, steps rejected in both,
+    // and steps cut short by a joint limit
+    int acceptedPos[STATS_MAX_JOINTS];
+    int acceptedNeg[STATS_MAX_JOINTS];
+    int rejected[STATS_MAX_JOINTS];
+    int limitClamps[STATS_MAX_JOINTS];
+    // Distance from the end effector to the target when the solve stopped
+    float finalError;
+    IKStopReason reason;
+
+    void (*hook)(const IKSolveStats& stats, void* data);
+    void* hookData;
+
+    void begin()
+    {
+        for(int p = 0; p < STATS_LERP_PHASES; p++)
+        {
+            phaseEvaluations[p] = 0;
+        }
+        for(int j = 0; j < STATS_MAX_JOINTS; j++)
+        {
+            acceptedPos[j] = acceptedNeg[j] = rejected[j] = limitClamps[j] = 0;
+        }
+        evaluations = 0;
+        finalError = 0.0f;
+        reason = IK_STOP_CONVERGED;
+        lastDirection = 0;
+        lastJoint = -1;
+        clamped = false;
+        for(int j = 0; j < STATS_MAX_JOINTS; j++)
+        {
+            clampRun[j] = 0;
+        }
+        reversalRun = 0;
+    }
+
+    void evaluation(float lerpPos)
+    {
+        int p = (int)(lerpPos*STATS_LERP_PHASES);
+        p = (p < 0) ? 0 : ((p >= STATS_LERP_PHASES) ? (STATS_LERP_PHASES - 1) : p);
+        phaseEvaluations[p]++;
+        evaluations++;
+    }
+
+    void clamp(int joint)
+    {
+        limitClamps[slot(joint)]++;
+        clamped = true;
+    }
+
+    // direction is +1 or -1 for an accepted step, 0 for a rejected one
+    void step(int joint, int direction)
+    {
+        const int s = slot(joint);
+        if(direction > 0)
+        {
+            acceptedPos[s]++;
+        }
+        else if(direction < 0)
+        {
+            acceptedNeg[s]++;
+        }
+        else
+        {
+            rejected[s]++;
+        }
+
+        clampRun[s] = clamped ? (clampRun[s] + 1) : 0;
+        clamped = false;
+        if(direction != 0)
+        {
+            reversalRun = (joint == lastJoint && direction == -lastDirection) ? (reversalRun + 1) : 0;
+            lastDirection = direction;
+            lastJoint = joint;
+        }
+    }
+
+    void finish(bool timedOut, float error)
+    {
+        finalError = error;
+        if(!timedOut)
+        {
+            reason = IK_STOP_CONVERGED;
+        }
+        else if(stuck())
+        {
+            reason = IK_STOP_JOINT_LIMIT;
+        }
+        else if(reversalRun >= STATS_OSCILLATION_STEPS)
+        {
+            reason = IK_STOP_OSCILLATING;
+        }
+        else
+        {
+            reason = IK_STOP_TIMEOUT;
+        }
+        if(hook)
+        {
+            hook(*this, hookData);
+        }
+    }
+
+    // The workspace check turned the target away; error is only a lower
+    // bound on how far out of reach it is
+    void unreachable(float error)
+    {
+        finalError = error;
+        reason = IK_STOP_UNREACHABLE;
+        if(hook)
+        {
+            hook(*this, hookData);
+        }
+    }
+
+private:
+    static int slot(int joint)
+    {
+        return (joint < STATS_MAX_JOINTS) ? joint : (STATS_MAX_JOINTS - 1);
+    }
+
+    bool stuck() const
+    {
+        for(int j = 0; j < STATS_MAX_JOINTS; j++)
+        {
+            if(clampRun[j] >= STATS_STUCK_STEPS)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int lastDirection;
+    int lastJoint;
+    bool clamped;
+    int clampRun[STATS_MAX_JOINTS];
+    int reversalRun;
+};
+
+// Aggregates many solves: how each one stopped, and a histogram of the
+// evaluations they took. Pass IKStatsHistogram::record as the hook with the
+// histogram as hookData.
+#define STATS_HISTOGRAM_BINS 16
+#define STATS_HISTOGRAM_BIN_WIDTH 500
+
+struct IKStatsHistogram
+{
+    IKStatsHistogram()
+    {
+        solves = 0;
+        for(int r = 0; r < IK_STOP_REASONS; r++)
+        {
+            reasons[r] = 0;
+        }
+        for(int b = 0; b < STATS_HISTOGRAM_BINS; b++)
+        {
+            evaluationBins[b] = 0;
+        }
+        for(int p = 0; p < STATS_LERP_PHASES; p++)
+        {
+            phaseEvaluations[p] = 0;
+        }
+    }
+
+    int solves;
+    // Indexed by IKStopReason
+    int reasons[IK_STOP_REASONS];
+    // Bin b counts solves taking [b, b+1)*STATS_HISTOGRAM_BIN_WIDTH evaluations
+    int evaluationBins[STATS_HISTOGRAM_BINS];
+    long long phaseEvaluations[STATS_LERP_PHASES];
+
+    static void record(const IKSolveStats& stats, void* data)
+    {
+        IKStatsHistogram* self = (IKStatsHistogram*)data;
+        self->solves++;
+        self->reasons[stats.reason]++;
+        int b = stats.evaluations/STATS_HISTOGRAM_BIN_WIDTH;
+        self->evaluationBins[(b < STATS_HISTOGRAM_BINS) ? b : (STATS_HISTOGRAM_BINS - 1)]++;
+        for(int p = 0; p < STATS_LERP_PHASES; p++)
+        {
+            self->phaseEvaluations[p] += stats.phaseEvaluations[p];
+        }
+    }
+};
+
+#endif // _IK_SOLVE_STATS_H_
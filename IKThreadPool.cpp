@@ -0,0 +1,168 @@
+/*
+ *     IKThreadPool.cpp
+ *
+ *     This file implements the work-stealing thread pool.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "IKThreadPool.h"
+
+using namespace std;
+
+IKThreadPool::IKThreadPool(int nThreads) :
+    nWorkers(nThreads),
+    job(0),
+    generation(0),
+    pending(0),
+    busy(0),
+    stopping(false)
+{
+    if(nWorkers <= 0)
+    {
+        nWorkers = (int)thread::hardware_concurrency();
+        if(nWorkers <= 0)
+        {
+            nWorkers = 1;
+        }
+    }
+    queues = new TaskQueue[nWorkers];
+    // Worker 0 is whoever calls run()
+    for(int w = 1; w < nWorkers; w++)
+    {
+        threads.push_back(thread(&IKThreadPool::workerLoop, this, w));
+    }
+}
+
+IKThreadPool::~IKThreadPool()
+{
+    {
+        lock_guard<mutex> guard(jobLock);
+        stopping = true;
+    }
+    jobStart.notify_all();
+    for(size_t t = 0; t < threads.size(); t++)
+    {
+        threads[t].join();
+    }
+    delete[] queues;
+}
+
+void IKThreadPool::run(int nTasks, const function<void(int, int)>& task)
+{
+    if(nTasks <= 0)
+    {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(jobLock);
+        // Hand each worker a contiguous block so neighbouring tasks stay on
+        // the same core unless they get stolen
+        for(int w = 0; w < nWorkers; w++)
+        {
+            lock_guard<mutex> queueGuard(queues[w].lock);
+            for(int t = (int)(((long long)nTasks*w)/nWorkers); t < (int)(((long long)nTasks*(w+1))/nWorkers); t++)
+            {
+                queues[w].tasks.push_back(t);
+            }
+        }
+        job = &task;
+        pending = nTasks;
+        generation++;
+    }
+    jobStart.notify_all();
+
+    drain(0, task);
+
+    unique_lock<mutex> guard(jobLock);
+    while(pending > 0 || busy > 0)
+    {
+        jobDone.wait(guard);
+    }
+    job = 0;
+}
+
+void IKThreadPool::workerLoop(int worker)
+{
+    unsigned seen = 0;
+    unique_lock<mutex> guard(jobLock);
+    for(;;)
+    {
+        while(!stopping && (seen == generation || job == 0))
+        {
+            jobStart.wait(guard);
+        }
+        if(stopping)
+        {
+            return;
+        }
+        seen = generation;
+        const function<void(int, int)>* task = job;
+        busy++;
+        guard.unlock();
+
+        drain(worker, *task);
+
+        guard.lock();
+        busy--;
+        if(pending == 0 && busy == 0)
+        {
+            jobDone.notify_all();
+        }
+    }
+}
+
+void IKThreadPool::drain(int worker, const function<void(int, int)>& task)
+{
+    int t;
+    while(nextTask(worker, t))
+    {
+        task(t, worker);
+        lock_guard<mutex> guard(jobLock);
+        pending--;
+        if(pending == 0)
+        {
+            jobDone.notify_all();
+        }
+    }
+}
+
+bool IKThreadPool::nextTask(int worker, int& task)
+{
+    {
+        lock_guard<mutex> guard(queues[worker].lock);
+        if(!queues[worker].tasks.empty())
+        {
+            task = queues[worker].tasks.front();
+            queues[worker].tasks.pop_front();
+            return true;
+        }
+    }
+    // Own queue is empty, steal from the back of someone else's
+    for(int k = 1; k < nWorkers; k++)
+    {
+        TaskQueue& victim = queues[(worker + k) % nWorkers];
+        lock_guard<mutex> guard(victim.lock);
+        if(!victim.tasks.empty())
+        {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
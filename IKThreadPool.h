@@ -0,0 +1,76 @@
+/*
+ *     IKThreadPool.h
+ *
+ *     This file declares the work-stealing thread pool used to spread solves
+ *     across cores.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_THREAD_POOL_H_
+#define _IK_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class IKThreadPool
+{
+public:
+    // nThreads <= 0 uses one thread per hardware thread. The thread calling
+    // run() counts as one of them.
+    explicit IKThreadPool(int nThreads = 0);
+    ~IKThreadPool();
+
+    int size() const { return nWorkers; }
+
+    // Calls task(taskIndex, workerIndex) for every taskIndex in [0, nTasks)
+    // and returns once all of them have finished. Each worker starts on a
+    // contiguous block of tasks and steals from the back of the other
+    // workers' queues when its own runs dry. workerIndex is in [0, size())
+    // and can be used to index per-thread state. Not reentrant.
+    void run(int nTasks, const std::function<void(int, int)>& task);
+
+private:
+    struct TaskQueue
+    {
+        std::mutex lock;
+        std::deque<int> tasks;
+    };
+
+    void workerLoop(int worker);
+    void drain(int worker, const std::function<void(int, int)>& task);
+    bool nextTask(int worker, int& task);
+
+    int nWorkers;
+    TaskQueue* queues;
+    std::vector<std::thread> threads;
+
+    std::mutex jobLock;
+    std::condition_variable jobStart;
+    std::condition_variable jobDone;
+    const std::function<void(int, int)>* job;
+    unsigned generation;
+    int pending;
+    int busy;
+    bool stopping;
+};
+
+#endif // _IK_THREAD_POOL_H_
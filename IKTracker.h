@@ -0,0 +1,130 @@
+/*
+ *     IKTracker.h
+ *
+ *     This file implements a warm-started solver for streaming targets.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_TRACKER_H_
+#define _IK_TRACKER_H_
+
+#include "IKSolve.h"
+
+// Default number of forward solves an update() may spend
+#define IK_TRACK_MAX_EVALS 64
+// Forward solves an update() spends outside the descent's own budget: one
+// checking the current position, one on the solver's start position, one
+// on the final position, and up to two the solver may overshoot by
+#define IK_TRACK_OVERHEAD 5
+
+struct IKTrackResult
+{
+    // The end effector is within reqError of the target
+    bool converged;
+    // Forward solves spent by this update (an upper bound if the solver ran
+    // out of budget or time), never more than maxEvaluations (at least 1)
+    int evaluations;
+    // Distance from the end effector to the target after the update
+    float error;
+};
+
+// Follows a moving target by descending from the previous solution instead of
+// from the zero pose. Each update() is bounded to maxEvaluations forward
+// solves; a target that could not be reached in one tick is simply picked up
+// again from the partial solution on the next tick, and so is one that
+// runs past the deadline passed to update(). An update needs
+// IK_TRACK_OVERHEAD evaluations besides the descent itself, so with a
+// smaller budget it only checks whether the current pose is close enough.
+template<int N, class FK>
+class IKTracker
+{
+public:
+    IKTracker(const float ranges[][2], const float* radii, FK forwardSolve, float reqError, int maxEvaluations = IK_TRACK_MAX_EVALS) :
+        jointRanges(ranges),
+        jointRadii(radii),
+        fk(forwardSolve),
+        maxError(reqError),
+        solveBudget((maxEvaluations > IK_TRACK_OVERHEAD) ? (maxEvaluations - IK_TRACK_OVERHEAD) : 0)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            jointAngles[j] = 0.0f;
+        }
+        curPos = fk(jointAngles);
+    }
+
+    // Starts tracking from the given pose
+    void reset(const float* angles)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            jointAngles[j] = angles[j];
+        }
+        curPos = fk(jointAngles);
+    }
+
+    IKTrackResult update(const Vector2d& target, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max())
+    {
+        IKTrackResult res;
+        curPos = fk(jointAngles);
+        res.evaluations = 1;
+        res.error = (curPos-target).magnitude();
+        res.converged = (res.error <= maxError);
+        if(res.converged || solveBudget == 0)
+        {
+            return res;
+        }
+
+        IKNoStats stats;
+        IKSolveOptions options;
+        options.maxEvaluations = solveBudget;
+        options.deadline = deadline;
+        options.coldStart = false;
+        options.lerpStep = 1.0f;
+        int solve_res = solveImplStats<N>(jointAngles, jointRanges, jointRadii, N, fk, target, maxError, options, stats);
+        res.evaluations += 1 + ((solve_res == -1) ? (solveBudget + 2) : solve_res);
+
+        curPos = fk(jointAngles);
+        res.evaluations++;
+        res.error = (curPos-target).magnitude();
+        res.converged = (res.error <= maxError);
+        return res;
+    }
+
+    const float* angles() const { return jointAngles; }
+    const Vector2d& position() const { return curPos; }
+
+private:
+    const float (*jointRanges)[2];
+    const float* jointRadii;
+    FK fk;
+    float maxError;
+    int solveBudget;
+    float jointAngles[N];
+    Vector2d curPos;
+};
+
+// Deduces the forward kinematics type, e.g.
+// auto tracker = makeTracker<2>(ranges, radii, [](float* a){ return ...; }, 1.0f);
+template<int N, class FK>
+inline IKTracker<N, FK> makeTracker(const float ranges[][2], const float* radii, FK forwardSolve, float reqError, int maxEvaluations = IK_TRACK_MAX_EVALS)
+{
+    return IKTracker<N, FK>(ranges, radii, forwardSolve, reqError, maxEvaluations);
+}
+
+#endif // _IK_TRACKER_H_
@@ -0,0 +1,244 @@
+/*
+ *     IKTrajectory.h
+ *
+ *     This file implements the trajectory solver, which solves a sampled
+ *     end effector path into a continuous sequence of joint poses.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_TRAJECTORY_H_
+#define _IK_TRAJECTORY_H_
+
+#include "IKSolve.h"
+#include "IKThreadPool.h"
+
+#include <cmath>
+#include <vector>
+
+// Path points per segment handed to the thread pool
+#define IK_TRAJECTORY_SEGMENT 64
+// Default largest joint space distance (radians) between consecutive poses
+#define IK_TRAJECTORY_MAX_JUMP 0.25f
+
+enum IKTrajectoryStatus
+{
+    // Within reqError of the path point
+    IK_TRAJECTORY_OK,
+    // Solved, but a joint velocity limit held the pose back short of it
+    IK_TRAJECTORY_LIMITED,
+    // Not solved; the pose is the closest the descent found from the
+    // previous one, still within the limits, or the previous pose itself
+    // if that closest one was more than maxJump away
+    IK_TRAJECTORY_UNREACHED
+};
+
+struct IKTrajectoryLimits
+{
+    IKTrajectoryLimits() :
+        maxVelocity(0),
+        dt(0.0f),
+        maxJump(IK_TRAJECTORY_MAX_JUMP),
+        maxEvaluations(IK_TIMEOUT)
+    {
+    }
+
+    // Per joint, in radians per second, or 0 for no velocity limits. A joint
+    // may move at most maxVelocity[j]*dt between consecutive points.
+    const float* maxVelocity;
+    // Seconds between consecutive path points
+    float dt;
+    // No pose is taken further than this joint space distance from the
+    // previous one, so the legs never flip branch mid-path: a point the warm
+    // start can't reach within it is solved again from the zero pose, and if
+    // that lands too far away as well, the previous pose is held
+    float maxJump;
+    // Forward solves per attempt at a point
+    int maxEvaluations;
+};
+
+// Samples the polyline through count waypoints every spacing along its
+// length, ending on the last waypoint. Leaves path empty if spacing isn't
+// positive.
+inline void samplePath(const Vector2d* waypoints, int count, float spacing, std::vector<Vector2d>& path)
+{
+    path.clear();
+    if(count <= 0 || !(spacing > 0.0f))
+    {
+        return;
+    }
+    path.push_back(waypoints[0]);
+    // Distance along the current leg of the polyline to the next sample
+    float next = spacing;
+    for(int w = 1; w < count; w++)
+    {
+        Vector2d from = waypoints[w-1], to = waypoints[w];
+        const float length = (to-from).magnitude();
+        for(; next < length; next += spacing)
+        {
+            path.push_back(from.lerp(to, next/length));
+        }
+        next -= length;
+    }
+    path.push_back(waypoints[count-1]);
+}
+
+// Whether the step from pose a to pose b stays within the limits
+template<int N>
+inline bool trajectoryContinuous(const float* a, const float* b, const IKTrajectoryLimits& limits)
+{
+    float distance = 0.0f;
+    for(int j = 0; j < N; j++)
+    {
+        const float d = b[j] - a[j];
+        if(limits.maxVelocity && std::fabs(d) > limits.maxVelocity[j]*limits.dt)
+        {
+            return false;
+        }
+        distance += d*d;
+    }
+    return distance <= limits.maxJump*limits.maxJump;
+}
+
+// Solves one path point into pose. With a previous pose, descends straight
+// from it and falls back to a cold start, taking neither further than
+// limits.maxJump away (holding the previous pose if both are), then clamps
+// every joint to its velocity limit; without one (the first point of a
+// path or segment), solves from the zero pose like solve().
+template<int N, class FK>
+inline IKTrajectoryStatus solveTrajectoryPoint(float* pose, const float* prev, const Vector2d& target, const float ranges[][2], const float* radii, FK& forwardSolve, const float reqError, const IKTrajectoryLimits& limits)
+{
+    IKSolveOptions options;
+    options.maxEvaluations = limits.maxEvaluations;
+    if(!prev)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            pose[j] = 0.0f;
+        }
+        return (solve<N>(pose, ranges, radii, forwardSolve, target, reqError, options) == -1) ? IK_TRAJECTORY_UNREACHED : IK_TRAJECTORY_OK;
+    }
+
+    for(int j = 0; j < N; j++)
+    {
+        pose[j] = prev[j];
+    }
+    options.coldStart = false;
+    options.lerpStep = 1.0f;
+    options.bestEffort = true;
+    IKTrajectoryLimits jumpOnly;
+    jumpOnly.maxJump = limits.maxJump;
+    int res = solve<N>(pose, ranges, radii, forwardSolve, target, reqError, options);
+    res = trajectoryContinuous<N>(prev, pose, jumpOnly) ? res : -1;
+    if(res == -1)
+    {
+        float cold[N];
+        for(int j = 0; j < N; j++)
+        {
+            cold[j] = 0.0f;
+        }
+        IKSolveOptions coldOptions;
+        coldOptions.maxEvaluations = limits.maxEvaluations;
+        if(solve<N>(cold, ranges, radii, forwardSolve, target, reqError, coldOptions) != -1 && trajectoryContinuous<N>(prev, cold, jumpOnly))
+        {
+            res = 0;
+            for(int j = 0; j < N; j++)
+            {
+                pose[j] = cold[j];
+            }
+        }
+    }
+    for(int j = 0; res == -1 && !trajectoryContinuous<N>(prev, pose, jumpOnly) && j < N; j++)
+    {
+        // Even the closest pose the warm start found is too far away
+        pose[j] = prev[j];
+    }
+
+    IKTrajectoryStatus status = (res == -1) ? IK_TRAJECTORY_UNREACHED : IK_TRAJECTORY_OK;
+    for(int j = 0; limits.maxVelocity && j < N; j++)
+    {
+        const float maxStep = limits.maxVelocity[j]*limits.dt;
+        if(pose[j] > prev[j] + maxStep || pose[j] < prev[j] - maxStep)
+        {
+            pose[j] = (pose[j] > prev[j]) ? (prev[j] + maxStep) : (prev[j] - maxStep);
+            status = (status == IK_TRAJECTORY_OK) ? IK_TRAJECTORY_LIMITED : status;
+        }
+    }
+    return status;
+}
+
+// Solves path[begin, end) in order, each point warm started from the one
+// before it; start is the pose before path[begin], or 0 if unknown
+template<int N, class FK>
+inline void solveTrajectorySegment(const Vector2d* path, int begin, int end, const float* start, const float ranges[][2], const float* radii, FK forwardSolve, const float reqError, const IKTrajectoryLimits& limits, float* angles, IKTrajectoryStatus* status)
+{
+    for(int k = begin; k < end; k++)
+    {
+        const float* prev = (k == begin) ? start : &angles[(k-1)*N];
+        status[k] = solveTrajectoryPoint<N>(&angles[k*N], prev, path[k], ranges, radii, forwardSolve, reqError, limits);
+    }
+}
+
+// Solves the count points of path into angles, joint j of point k at
+// angles[k*N + j], with status[k] saying how point k went. Every point is
+// warm started from the previous solution (the first from start, or from
+// the zero pose if start is 0), so consecutive poses stay on the same
+// branch and within limits. Returns the number of IK_TRAJECTORY_OK points.
+//
+// With a pool, the path is split into IK_TRAJECTORY_SEGMENT point segments
+// solved concurrently, each starting cold. The segments are then stitched in
+// order: the points after a boundary are solved again from the pose before
+// them until the existing solution joins up within limits, at most up to
+// the next boundary (whose own stitch carries on from there), so stitching
+// solves each point at most once more. A stitched trajectory obeys the same
+// limits as a sequential one, but may settle on slightly different poses.
+template<int N, class FK>
+int solveTrajectory(const Vector2d* path, int count, const float* start, const float ranges[][2], const float* radii, FK forwardSolve, const float& reqError, const IKTrajectoryLimits& limits, float* angles, IKTrajectoryStatus* status, IKThreadPool* pool = 0)
+{
+    if(!pool || count <= IK_TRAJECTORY_SEGMENT)
+    {
+        solveTrajectorySegment<N>(path, 0, count, start, ranges, radii, forwardSolve, reqError, limits, angles, status);
+    }
+    else
+    {
+        const int segments = (count + IK_TRAJECTORY_SEGMENT - 1)/IK_TRAJECTORY_SEGMENT;
+        pool->run(segments, [&](int s, int)
+        {
+            const int begin = s*IK_TRAJECTORY_SEGMENT;
+            const int end = (begin + IK_TRAJECTORY_SEGMENT < count) ? (begin + IK_TRAJECTORY_SEGMENT) : count;
+            solveTrajectorySegment<N>(path, begin, end, (s == 0) ? start : 0, ranges, radii, forwardSolve, reqError, limits, angles, status);
+        });
+
+        for(int k = IK_TRAJECTORY_SEGMENT; k < count; k += IK_TRAJECTORY_SEGMENT)
+        {
+            const int end = (k + IK_TRAJECTORY_SEGMENT < count) ? (k + IK_TRAJECTORY_SEGMENT) : count;
+            for(int m = k; m < end && !trajectoryContinuous<N>(&angles[(m-1)*N], &angles[m*N], limits); m++)
+            {
+                status[m] = solveTrajectoryPoint<N>(&angles[m*N], &angles[(m-1)*N], path[m], ranges, radii, forwardSolve, reqError, limits);
+            }
+        }
+    }
+
+    int solved = 0;
+    for(int k = 0; k < count; k++)
+    {
+        solved += (status[k] == IK_TRAJECTORY_OK) ? 1 : 0;
+    }
+    return solved;
+}
+
+#endif // _IK_TRAJECTORY_H_
@@ -0,0 +1,307 @@
+/*
+ *     IKWorkspace.h
+ *
+ *     This file implements a precomputed map of the positions an end effector
+ *     can reach, used to turn unreachable targets away before solving.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _IK_WORKSPACE_H_
+#define _IK_WORKSPACE_H_
+
+#include "VectorLib/Vector.h"
+
+#include <cmath>
+#include <vector>
+
+// Joint space samples per joint when building the map
+#define WORKSPACE_SAMPLES 256
+// Cells along the longer side of the workspace's bounding box
+#define WORKSPACE_CELLS 128
+// Largest ratio of the 8-neighbour chamfer distance to the Euclidean one
+#define WORKSPACE_CHAMFER_RATIO 1.0824f
+
+// Occupancy grid of the workspace, built by sampling the forward kinematics
+// over the joint ranges, plus a chamfer distance field from every cell to the
+// nearest occupied one. reachable() is O(1) and conservative: it only rejects
+// a target if no pose can bring the end effector within reqError of it,
+// allowing for the cell size and the spacing between samples, so a solve it
+// turns away would have failed anyway.
+class IKWorkspace
+{
+public:
+    IKWorkspace() :
+        nJoints(0),
+        xLower(0.0f), yLower(0.0f),
+        xUpper(0.0f), yUpper(0.0f),
+        cell(1.0f),
+        slack(0.0f),
+        xCells(0), yCells(0)
+    {
+    }
+
+    // Samples samplesPerJoint^N poses, so keep N small
+    template<int N, class FK>
+    void build(const float ranges[][2], FK forwardSolve, int samplesPerJoint = WORKSPACE_SAMPLES, int cells = WORKSPACE_CELLS)
+    {
+        nJoints = N;
+        int index[N];
+        float angles[N];
+
+        // First pass: bounding box, and the largest distance between the
+        // positions of neighbouring samples
+        float gap = 0.0f;
+        bool first = true;
+        for(int k = 0; k < N; k++)
+        {
+            index[k] = 0;
+        }
+        do
+        {
+            sampleAngles<N>(ranges, samplesPerJoint, index, angles);
+            const Vector2d pos = forwardSolve(angles);
+            xLower = (first || pos.x < xLower) ? pos.x : xLower;
+            xUpper = (first || pos.x > xUpper) ? pos.x : xUpper;
+            yLower = (first || pos.y < yLower) ? pos.y : yLower;
+            yUpper = (first || pos.y > yUpper) ? pos.y : yUpper;
+            first = false;
+            for(int k = 0; k < N; k++)
+            {
+                if(index[k] + 1 < samplesPerJoint)
+                {
+                    const float prev = angles[k];
+                    angles[k] = sampleAngle(ranges[k], samplesPerJoint, index[k] + 1);
+                    const float d = (forwardSolve(angles) - pos).magnitude();
+                    gap = (d > gap) ? d : gap;
+                    angles[k] = prev;
+                }
+            }
+        }
+        while(nextSample<N>(index, samplesPerJoint));
+
+        // One empty cell of margin on every side
+        const float longest = ((xUpper - xLower) > (yUpper - yLower)) ? (xUpper - xLower) : (yUpper - yLower);
+        cell = (longest > 0.0f) ? (longest/cells) : 1.0f;
+        xCells = (int)((xUpper - xLower)/cell) + 3;
+        yCells = (int)((yUpper - yLower)/cell) + 3;
+        xLower -= cell;
+        yLower -= cell;
+        // Every reachable point is within gap of a sample, every sample is in
+        // an occupied cell, and both it and the target are within half a
+        // cell diagonal of their cells' centres
+        slack = gap + cell*std::sqrt(2.0f);
+
+        // Second pass: occupied cells, keeping the first sample in each
+        distance.assign(xCells*yCells, 1.0e9f);
+        seeds.assign(xCells*yCells*(N + 2), 0.0f);
+        for(int k = 0; k < N; k++)
+        {
+            index[k] = 0;
+        }
+        do
+        {
+            sampleAngles<N>(ranges, samplesPerJoint, index, angles);
+            const Vector2d pos = forwardSolve(angles);
+            const int c = cellIndex((int)((pos.x - xLower)/cell), (int)((pos.y - yLower)/cell));
+            if(distance[c] != 0.0f)
+            {
+                distance[c] = 0.0f;
+                float* seed = &seeds[c*(N + 2)];
+                seed[0] = pos.x;
+                seed[1] = pos.y;
+                for(int k = 0; k < N; k++)
+                {
+                    seed[2 + k] = angles[k];
+                }
+            }
+        }
+        while(nextSample<N>(index, samplesPerJoint));
+
+        chamfer();
+    }
+
+    bool built() const
+    {
+        return nJoints > 0;
+    }
+
+    // Lower bound on the distance from target to any reachable point
+    float distanceBound(const Vector2d& target) const
+    {
+        const float gx = (target.x - xLower)/cell;
+        const float gy = (target.y - yLower)/cell;
+        if(gx < 0.0f || gy < 0.0f || gx >= xCells || gy >= yCells)
+        {
+            // Outside the grid the bounding box is the best we know
+            const float dx = (target.x < xLower) ? (xLower - target.x) : ((target.x > xLower + xCells*cell) ? (target.x - xLower - xCells*cell) : 0.0f);
+            const float dy = (target.y < yLower) ? (yLower - target.y) : ((target.y > yLower + yCells*cell) ? (target.y - yLower - yCells*cell) : 0.0f);
+            return std::sqrt(dx*dx + dy*dy);
+        }
+        const float d = distance[cellIndex((int)gx, (int)gy)]*cell/WORKSPACE_CHAMFER_RATIO - slack;
+        return (d > 0.0f) ? d : 0.0f;
+    }
+
+    // False only if no pose can bring the end effector within reqError of
+    // target
+    bool reachable(const Vector2d& target, float reqError) const
+    {
+        return !built() || distanceBound(target) <= reqError;
+    }
+
+    // Finds the occupied cell nearest target and returns the sampled position
+    // in it, and the pose that reaches it if angles is given. Returns false
+    // if the map is empty.
+    bool nearestReachable(const Vector2d& target, Vector2d& point, float* angles = 0) const
+    {
+        int ci = (int)std::floor((target.x - xLower)/cell);
+        int cj = (int)std::floor((target.y - yLower)/cell);
+        ci = (ci < 0) ? 0 : ((ci >= xCells) ? (xCells - 1) : ci);
+        cj = (cj < 0) ? 0 : ((cj >= yCells) ? (yCells - 1) : cj);
+        const int maxRadius = (xCells > yCells) ? xCells : yCells;
+
+        // Search square rings outwards. A hit on ring r may be up to r*sqrt(2)
+        // cells away, so keep going until no later ring can be closer.
+        int best = -1;
+        float bestDist = 0.0f;
+        int lastRing = maxRadius;
+        for(int r = 0; r <= lastRing; r++)
+        {
+            for(int dj = -r; dj <= r; dj++)
+            {
+                for(int di = -r; di <= r; di++)
+                {
+                    const int i = ci + di, j = cj + dj;
+                    if((di != -r && di != r && dj != -r && dj != r) ||
+                       i < 0 || j < 0 || i >= xCells || j >= yCells ||
+                       distance[cellIndex(i, j)] != 0.0f)
+                    {
+                        continue;
+                    }
+                    const float* seed = &seeds[cellIndex(i, j)*(nJoints + 2)];
+                    const float dx = seed[0] - target.x, dy = seed[1] - target.y;
+                    const float dist = dx*dx + dy*dy;
+                    if(best == -1 || dist < bestDist)
+                    {
+                        best = cellIndex(i, j);
+                        bestDist = dist;
+                        const int limit = (int)std::ceil(r*1.4143f) + 1;
+                        lastRing = (limit < lastRing) ? limit : lastRing;
+                    }
+                }
+            }
+        }
+        if(best == -1)
+        {
+            return false;
+        }
+        const float* seed = &seeds[best*(nJoints + 2)];
+        point = Vector2d(seed[0], seed[1]);
+        for(int k = 0; angles && k < nJoints; k++)
+        {
+            angles[k] = seed[2 + k];
+        }
+        return true;
+    }
+
+private:
+    static float sampleAngle(const float range[2], int samples, int index)
+    {
+        return (samples > 1) ? (range[0] + (range[1] - range[0])*index/(samples - 1)) : range[0];
+    }
+
+    template<int N>
+    static void sampleAngles(const float ranges[][2], int samples, const int* index, float* angles)
+    {
+        for(int k = 0; k < N; k++)
+        {
+            angles[k] = sampleAngle(ranges[k], samples, index[k]);
+        }
+    }
+
+    // Steps index through every combination, joint 0 fastest
+    template<int N>
+    static bool nextSample(int* index, int samples)
+    {
+        for(int k = 0; k < N; k++)
+        {
+            if(++index[k] < samples)
+            {
+                return true;
+            }
+            index[k] = 0;
+        }
+        return false;
+    }
+
+    int cellIndex(int i, int j) const
+    {
+        i = (i < 0) ? 0 : ((i >= xCells) ? (xCells - 1) : i);
+        j = (j < 0) ? 0 : ((j >= yCells) ? (yCells - 1) : j);
+        return j*xCells + i;
+    }
+
+    // Lowers d to the distance through neighbour (i, j), w cells away
+    void relax(float& d, int i, int j, float w) const
+    {
+        if(i >= 0 && j >= 0 && i < xCells && j < yCells && distance[j*xCells + i] + w < d)
+        {
+            d = distance[j*xCells + i] + w;
+        }
+    }
+
+    // Two pass 8-neighbour chamfer transform, in cells
+    void chamfer()
+    {
+        const float diagonal = std::sqrt(2.0f);
+        for(int j = 0; j < yCells; j++)
+        {
+            for(int i = 0; i < xCells; i++)
+            {
+                float& d = distance[j*xCells + i];
+                relax(d, i - 1, j, 1.0f);
+                relax(d, i, j - 1, 1.0f);
+                relax(d, i - 1, j - 1, diagonal);
+                relax(d, i + 1, j - 1, diagonal);
+            }
+        }
+        for(int j = yCells - 1; j >= 0; j--)
+        {
+            for(int i = xCells - 1; i >= 0; i--)
+            {
+                float& d = distance[j*xCells + i];
+                relax(d, i + 1, j, 1.0f);
+                relax(d, i, j + 1, 1.0f);
+                relax(d, i + 1, j + 1, diagonal);
+                relax(d, i - 1, j + 1, diagonal);
+            }
+        }
+    }
+
+    int nJoints;
+    float xLower, yLower;
+    float xUpper, yUpper;
+    float cell;
+    float slack;
+    int xCells, yCells;
+    // Chamfer distance (in cells) to the nearest occupied cell, 0 if occupied
+    std::vector<float> distance;
+    // Per occupied cell: sampled x, y, then the N joint angles
+    std::vector<float> seeds;
+};
+
+#endif // _IK_WORKSPACE_H_
@@ -1,33 +1,33 @@
 #include "LegLUT.h"
-const int16_t legPosLUT [2][35][30] = {
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -60}, {-60, 126}, {126, -60}, {-60, 126}, {126, -60}, {-60, -60}, {-60, 126}, {126, -60}, {-60, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -60}, {-60, 126}, {126, -57}, {-57, -56}, {-56, 126}, {126, -54}, {-54, -53}, {-53, 126}, {126, -53}, {-53, 126}, {126, -55}, {-55, -59}, {-59, -60}, {-60, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -60}, {-60, 126}, {126, -56}, {-56, -54}, {-54, 126}, {126, -51}, {-51, 126}, {126, 126}, {126, -48}, {-48, 126}, {126, -47}, {-47, -47}, {-47, -47}, {-47, -49}, {-49, -51}, {-51, -56}, {-56, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -59}, {-59, -56}, {-56, 126}, {126, -52}, {-52, -50}, {-50, 126}, {126, -47}, {-47, -45}, {-45, 126}, {126, -43}, {-43, 126}, {126, -42}, {-42, 126}, {126, -41}, {-41, -42}, {-42, -43}, {-43, -45}, {-45, -48}, {-48, -54}, {-54, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, -60}, {-60, 126}, {126, -55}, {-55, 126}, {126, -51}, {-51, 126}, {126, -46}, {-46, 126}, {126, -43}, {-43, -41}, {-41, 126}, {126, -39}, {-39, -38}, {-38, -37}, {-37, -37}, {-37, -36}, {-36, -37}, {-37, -37}, {-37, -38}, {-38, -40}, {-40, -42}, {-42, -48}, {-48, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, -60}, {-60, 126}, {126, -55}, {-55, -53}, {-53, 126}, {126, -48}, {-48, 126}, {126, -43}, {-43, -41}, {-41, 126}, {126, 126}, {126, 126}, {126, -35}, {-35, -34}, {-34, -33}, {-33, -32}, {-32, -32}, {-32, -32}, {-32, -32}, {-32, -33}, {-33, -34}, {-34, -35}, {-35, -38}, {-38, -43}, {-43, -48}, {-48, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, -58}, {-58, -55}, {-55, -53}, {-53, -50}, {-50, 126}, {126, -44}, {-44, 126}, {126, -40}, {-40, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -31}, {-31, -30}, {-30, -29}, {-29, -28}, {-28, -28}, {-28, -27}, {-27, -27}, {-27, -28}, {-28, -29}, {-29, -30}, {-30, -31}, {-31, -34}, {-34, -39}, {-39, -46}, {-46, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, -56}, {-56, 126}, {126, -50}, {-50, 126}, {126, -44}, {-44, -42}, {-42, -39}, {-39, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -27}, {-27, -26}, {-26, -25}, {-25, -24}, {-24, -24}, {-24, -23}, {-23, -23}, {-23, -23}, {-23, -24}, {-24, -25}, {-25, -26}, {-26, -28}, {-28, -31}, {-31, -35}, {-35, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, -48}, {-48, 126}, {126, -42}, {-42, 126}, {126, -36}, {-36, -34}, {-34, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -24}, {-24, -22}, {-22, -21}, {-21, -20}, {-20, -20}, {-20, -19}, {-19, -19}, {-19, -19}, {-19, -19}, {-19, -20}, {-20, -21}, {-21, -23}, {-23, -25}, {-25, -28}, {-28, -33}, {-33, -41}, {-41, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -42}, {-42, 126}, {126, -36}, {-36, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -20}, {-20, -19}, {-19, -18}, {-18, -17}, {-17, -16}, {-16, -15}, {-15, -15}, {-15, -15}, {-15, -15}, {-15, -16}, {-16, -17}, {-17, -18}, {-18, -20}, {-20, -22}, {-22, -26}, {-26, -32}, {-32, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -39}, {-39, -37}, {-37, -34}, {-34, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -17}, {-17, -15}, {-15, -14}, {-14, -13}, {-13, -12}, {-12, -12}, {-12, -11}, {-11, -11}, {-11, -11}, {-11, -12}, {-12, -13}, {-13, -14}, {-14, -15}, {-15, -17}, {-17, -20}, {-20, -24}, {-24, -31}, {-31, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -31}, {-31, -28}, {-28, -25}, {-25, -22}, {-22, -20}, {-20, -17}, {-17, -15}, {-15, -13}, {-13, -12}, {-12, -10}, {-10, -9}, {-9, -8}, {-8, -8}, {-8, -7}, {-7, -7}, {-7, -7}, {-7, -8}, {-8, -8}, {-8, -9}, {-9, -11}, {-11, -13}, {-13, -15}, {-15, -18}, {-18, -23}, {-23, -31}, {-31, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -10}, {-10, -8}, {-8, -7}, {-7, -6}, {-6, -5}, {-5, -4}, {-4, -4}, {-4, -3}, {-3, -4}, {-4, -4}, {-4, -5}, {-5, -5}, {-5, -7}, {-7, -8}, {-8, -10}, {-10, -13}, {-13, -17}, {-17, -22}, {-22, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -26}, {-26, -23}, {-23, -19}, {-19, -16}, {-16, -13}, {-13, -11}, {-11, -8}, {-8, -6}, {-6, -4}, {-4, -3}, {-3, -2}, {-2, -1}, {-1, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, -1}, {-1, -2}, {-2, -3}, {-3, -4}, {-4, -6}, {-6, -9}, {-9, -12}, {-12, -16}, {-16, -25}, {-25, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -13}, {-13, 126}, {126, -7}, {-7, -5}, {-5, -3}, {-3, -1}, {-1, 0}, {0, 1}, {1, 2}, {2, 3}, {3, 3}, {3, 3}, {3, 3}, {3, 3}, {3, 2}, {2, 1}, {1, 0}, {0, 0}, {0, -2}, {-2, -4}, {-4, -7}, {-7, -11}, {-11, -17}, {-17, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -17}, {-17, 126}, {126, -10}, {-10, 126}, {126, -4}, {-4, 126}, {126, 0}, {0, 126}, {126, 4}, {4, 5}, {5, 6}, {6, 7}, {7, 7}, {7, 7}, {7, 7}, {7, 7}, {7, 6}, {6, 5}, {5, 4}, {4, 2}, {2, 1}, {1, 0}, {0, -3}, {-3, -6}, {-6, -11}, {-11, -17}, {-17, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -10}, {-10, -7}, {-7, -3}, {-3, 126}, {126, 126}, {126, 4}, {4, 126}, {126, 126}, {126, 9}, {9, 10}, {10, 11}, {11, 11}, {11, 11}, {11, 11}, {11, 10}, {10, 10}, {10, 9}, {9, 8}, {8, 6}, {6, 4}, {4, 2}, {2, 0}, {0, -2}, {-2, -6}, {-6, -12}, {-12, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, -7}, {-7, 126}, {126, 0}, {0, 3}, {3, 6}, {6, 8}, {8, 126}, {126, 12}, {12, 13}, {13, 14}, {14, 15}, {15, 15}, {15, 15}, {15, 15}, {15, 14}, {14, 13}, {13, 12}, {12, 11}, {11, 10}, {10, 8}, {8, 6}, {6, 4}, {4, 1}, {1, -2}, {-2, -7}, {-7, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 4}, {4, 126}, {126, 10}, {10, 13}, {13, 126}, {126, 16}, {16, 126}, {126, 18}, {18, 19}, {19, 19}, {19, 19}, {19, 19}, {19, 18}, {18, 17}, {17, 16}, {16, 15}, {15, 126}, {126, 12}, {12, 126}, {126, 7}, {7, 4}, {4, 126}, {126, -3}, {-3, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 0}, {0, 126}, {126, 8}, {8, 126}, {126, 15}, {15, 126}, {126, 19}, {19, 126}, {126, 22}, {22, 126}, {126, 23}, {23, 126}, {126, 23}, {23, 22}, {22, 22}, {22, 21}, {21, 126}, {126, 126}, {126, 17}, {17, 126}, {126, 13}, {13, 126}, {126, 126}, {126, 4}, {4, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 2}, {2, 126}, {126, 13}, {13, 16}, {16, 126}, {126, 22}, {22, 24}, {24, 126}, {126, 25}, {25, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 25}, {25, 25}, {25, 23}, {23, 22}, {22, 126}, {126, 18}, {18, 16}, {16, 14}, {14, 126}, {126, 8}, {8, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 5}, {5, 126}, {126, 18}, {18, 22}, {22, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 25}, {25, 126}, {126, 22}, {22, 126}, {126, 17}, {17, 126}, {126, 11}, {11, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 13}, {13, 126}, {126, 24}, {24, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 23}, {23, 20}, {20, 17}, {17, 126}, {126, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 17}, {17, 126}, {126, 126}, {126, 126}}, 
-{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+const int16_t legPosLUT [30][35][2] = {
 {{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
 {{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-60, -13}, {-60, -10}, {-60, -6}, {-60, -3}, {-60, 1}, {-60, 5}, {-60, 9}, {-60, 14}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-60, -22}, {-59, -19}, {-58, -15}, {-56, -14}, {-57, -10}, {-56, -6}, {-56, -2}, {-57, 2}, {-53, 3}, {-54, 8}, {-54, 12}, {-58, 18}, {-58, 23}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-60, -30}, {-56, -28}, {-56, -25}, {-55, -23}, {-53, -20}, {-52, -17}, {-52, -14}, {-51, -10}, {-49, -7}, {-49, -3}, {-49, 0}, {-50, 4}, {-51, 9}, {-52, 16}, {-56, 23}, {-53, 23}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {-60, -38}, {-57, -36}, {-57, -34}, {-56, -31}, {-52, -29}, {-51, -26}, {-49, -24}, {-48, -21}, {-47, -17}, {-46, -14}, {-44, -11}, {-43, -8}, {-44, -4}, {-43, 0}, {-43, 5}, {-42, 7}, {-43, 11}, {-48, 20}, {-46, 20}, {-50, 28}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {-60, -43}, {-60, -41}, {-57, -39}, {-53, -37}, {-51, -35}, {-49, -32}, {-47, -29}, {-45, -27}, {-43, -24}, {-42, -21}, {-41, -17}, {-40, -14}, {-39, -11}, {-39, -7}, {-38, -4}, {-38, 0}, {-39, 4}, {-39, 9}, {-38, 12}, {-43, 20}, {-47, 28}, {-47, 30}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {-60, -49}, {-60, -47}, {-55, -45}, {-53, -43}, {-50, -40}, {-47, -38}, {-45, -35}, {-43, -32}, {-41, -29}, {-40, -26}, {-38, -23}, {-37, -20}, {-36, -17}, {-35, -13}, {-34, -10}, {-34, -6}, {-33, -3}, {-34, 1}, {-34, 6}, {-35, 10}, {-35, 16}, {-36, 18}, {-41, 28}, {-39, 28}, {-47, 40}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {-59, -52}, {-55, -50}, {-52, -48}, {-49, -45}, {-46, -43}, {-44, -40}, {-43, -38}, {-39, -35}, {-39, -32}, {-35, -29}, {-35, -26}, {-33, -22}, {-32, -19}, {-30, -15}, {-29, -12}, {-29, -8}, {-28, -5}, {-28, -1}, {-28, 2}, {-28, 6}, {-28, 10}, {-28, 14}, {-32, 20}, {-32, 24}, {-35, 30}, {-44, 40}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {-55, -55}, {-55, -54}, {-52, -51}, {-49, -49}, {-46, -46}, {-44, -43}, {-39, -40}, {-39, -38}, {-34, -34}, {-32, -31}, {-31, -28}, {-29, -24}, {-28, -21}, {-26, -18}, {-26, -12}, {-25, -11}, {-24, -7}, {-24, -1}, {-24, 2}, {-24, 6}, {-25, 10}, {-26, 14}, {-28, 18}, {-29, 24}, {-33, 30}, {-40, 40}, {-43, 46}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {-50, -55}, {-47, -54}, {-44, -51}, {-41, -49}, {-39, -46}, {-36, -43}, {-34, -38}, {-31, -36}, {-29, -31}, {-27, -28}, {-26, -24}, {-24, -21}, {-23, -18}, {-21, -16}, {-21, -11}, {-20, -7}, {-20, -5}, {-20, -1}, {-20, 3}, {-21, 7}, {-22, 11}, {-23, 16}, {-25, 21}, {-27, 27}, {-32, 34}, {-40, 46}, {-38, 46}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {-46, -55}, {-41, -54}, {-38, -51}, {-35, -48}, {-33, -45}, {-31, -42}, {-28, -38}, {-27, -35}, {-23, -32}, {-21, -28}, {-20, -24}, {-18, -21}, {-18, -16}, {-17, -13}, {-16, -10}, {-16, -5}, {-16, -1}, {-16, 3}, {-16, 7}, {-17, 11}, {-18, 16}, {-20, 19}, {-22, 24}, {-24, 30}, {-29, 36}, {-35, 46}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-41, -55}, {-36, -54}, {-33, -50}, {-30, -47}, {-28, -42}, {-25, -38}, {-23, -35}, {-21, -32}, {-19, -28}, {-17, -24}, {-16, -21}, {-14, -18}, {-13, -13}, {-13, -10}, {-12, -7}, {-12, -3}, {-12, 1}, {-12, 5}, {-13, 9}, {-14, 13}, {-15, 19}, {-17, 22}, {-20, 27}, {-22, 34}, {-28, 41}, {-31, 47}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-33, -55}, {-30, -52}, {-27, -49}, {-26, -45}, {-23, -42}, {-18, -38}, {-16, -34}, {-15, -30}, {-13, -26}, {-12, -23}, {-11, -18}, {-9, -13}, {-9, -10}, {-8, -7}, {-8, -3}, {-8, 1}, {-8, 5}, {-8, 9}, {-9, 13}, {-11, 16}, {-12, 22}, {-14, 25}, {-18, 31}, {-20, 38}, {-27, 47}, {-28, 50}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-28, -55}, {-24, -49}, {-22, -45}, {-19, -42}, {-16, -38}, {-14, -34}, {-12, -30}, {-10, -26}, {-8, -23}, {-7, -18}, {-5, -16}, {-4, -12}, {-4, -7}, {-4, -3}, {-4, 1}, {-4, 5}, {-4, 9}, {-5, 13}, {-6, 16}, {-8, 20}, {-10, 25}, {-12, 31}, {-16, 35}, {-20, 41}, {-25, 50}, {126, 126}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-25, -55}, {-23, -52}, {-20, -48}, {-15, -44}, {-12, -40}, {-10, -34}, {-8, -30}, {-6, -26}, {-4, -23}, {-3, -18}, {-2, -16}, {-1, -12}, {0, -7}, {0, -3}, {0, 1}, {0, 5}, {-1, 9}, {-1, 13}, {-2, 16}, {-3, 20}, {-5, 25}, {-8, 28}, {-11, 35}, {-15, 39}, {-19, 47}, {-20, 49}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-20, -54}, {-17, -50}, {-14, -46}, {-11, -42}, {-8, -37}, {-5, -33}, {-3, -29}, {-3, -25}, {0, -20}, {0, -16}, {2, -12}, {2, -8}, {2, -4}, {2, 0}, {2, 4}, {2, 7}, {3, 11}, {3, 15}, {1, 19}, {1, 23}, {-3, 27}, {-5, 31}, {-7, 36}, {-10, 40}, {-17, 49}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-17, -54}, {-13, -50}, {-10, -46}, {-7, -42}, {-4, -37}, {-2, -33}, {1, -29}, {2, -25}, {4, -20}, {5, -16}, {6, -12}, {7, -8}, {7, -4}, {8, 0}, {7, 4}, {7, 7}, {6, 11}, {6, 15}, {4, 19}, {3, 23}, {1, 27}, {-1, 31}, {-3, 36}, {-6, 40}, {-13, 49}, {-15, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-14, -55}, {-9, -50}, {-6, -46}, {-3, -42}, {0, -37}, {2, -33}, {4, -29}, {6, -25}, {8, -20}, {9, -16}, {10, -12}, {11, -8}, {11, -4}, {11, 0}, {11, 4}, {11, 7}, {10, 11}, {9, 15}, {8, 19}, {7, 23}, {5, 27}, {3, 31}, {1, 36}, {-2, 40}, {-9, 49}, {-11, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-5, -52}, {-2, -46}, {1, -42}, {3, -37}, {6, -33}, {8, -29}, {10, -25}, {12, -20}, {13, -16}, {14, -12}, {15, -6}, {15, -2}, {15, 0}, {15, 4}, {15, 7}, {14, 11}, {13, 15}, {12, 19}, {11, 23}, {9, 27}, {7, 31}, {5, 36}, {2, 40}, {-5, 49}, {-7, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {-3, -52}, {2, -46}, {4, -42}, {7, -37}, {10, -33}, {12, -29}, {14, -22}, {16, -18}, {17, -13}, {18, -9}, {19, -6}, {19, -2}, {20, 3}, {19, 7}, {19, 10}, {18, 14}, {18, 18}, {16, 21}, {15, 25}, {13, 27}, {11, 31}, {8, 36}, {5, 40}, {-1, 47}, {-3, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {1, -52}, {5, -46}, {8, -42}, {11, -37}, {14, -33}, {16, -26}, {19, -22}, {20, -18}, {22, -13}, {22, -9}, {23, -4}, {23, 0}, {23, 3}, {23, 7}, {22, 10}, {21, 14}, {20, 18}, {19, 21}, {18, 25}, {17, 30}, {15, 34}, {12, 36}, {9, 40}, {4, 47}, {0, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {5, -52}, {9, -46}, {12, -42}, {15, -36}, {18, -30}, {21, -26}, {23, -19}, {25, -15}, {25, -10}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 10}, {25, 13}, {25, 17}, {25, 20}, {23, 24}, {22, 27}, {19, 30}, {17, 34}, {14, 39}, {13, 43}, {8, 47}, {4, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {8, -52}, {13, -46}, {16, -42}, {20, -36}, {23, -28}, {25, -23}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 24}, {25, 27}, {23, 32}, {21, 36}, {18, 39}, {16, 43}, {12, 47}, {8, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {13, -51}, {16, -45}, {21, -38}, {25, -31}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 34}, {25, 37}, {20, 41}, {18, 45}, {15, 49}, {11, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {14, -55}, {17, -51}, {23, -43}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 40}, {24, 41}, {22, 45}, {19, 49}, {15, 53}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {18, -55}, {21, -49}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 45}, {25, 48}, {20, 52}, {17, 55}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {22, -55}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 51}, {24, 52}, {126, 126}, {126, 126}}, 
+{{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, -55}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {25, 55}, {126, 126}, {126, 126}}, 
 {{126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}, {126, 126}}
 };
@@ -1,4 +1,5 @@
 #ifndef _LEG_LUT_H_
 #define _LEG_LUT_H_
+#include <stdint.h>
 extern const int16_t legPosLUT [30][35][2];
 #endif
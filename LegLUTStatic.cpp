@@ -0,0 +1,32 @@
+/*
+ *     LegLUTStatic.cpp
+ *
+ *     This file defines the leg lookup table, which the compiler generates
+ *     straight from the geometry in LegModel.h.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "LegLUTStatic.h"
+
+#ifdef IK_HAVE_CONSTEXPR
+
+constexpr IKTableC<LEG_LUT_X_STEPS, LEG_LUT_Y_STEPS, 2> legPosLUTStatic =
+    generateLUTConstexpr<LEG_LUT_X_STEPS, LEG_LUT_Y_STEPS, 2>(LEG_LUT_X_LOWER, LEG_LUT_Y_LOWER, LEG_LUT_X_STEP, LEG_LUT_Y_STEP,
+                                                              ranges, LegForwardConstexpr(), 1.0f, 180.0f/PI, LUT_UNREACHABLE);
+
+#endif // IK_HAVE_CONSTEXPR
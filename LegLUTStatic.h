@@ -0,0 +1,53 @@
+/*
+ *     LegLUTStatic.h
+ *
+ *     This file declares the leg lookup table generated at compile time,
+ *     straight from the geometry in LegModel.h (see LegLUTStatic.cpp).
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LEG_LUT_STATIC_H_
+#define _LEG_LUT_STATIC_H_
+
+#include "IKConstexpr.h"
+#include "IKLut.h"
+#include "LegModel.h"
+
+#ifdef IK_HAVE_CONSTEXPR
+
+// forwardSolve() in constant-evaluable form
+struct LegForwardConstexpr
+{
+    constexpr IKVec2C operator()(const float* angles) const
+    {
+        IKVec2C pos = {0.0f, 0.0f};
+        legForward<IK_PRECISION_CONSTEXPR>(angles, pos.x, pos.y);
+        return pos;
+    }
+};
+
+// Replaces the LegLUT.c that tester.cpp writes: same layout and units
+// (degrees, LUT_UNREACHABLE where the target is out of reach), but built by
+// the compiler, so it can't drift from LegModel.h. Use legPosLUTStatic.data
+// wherever legPosLUT was used. Defined in LegLUTStatic.cpp, so only that file
+// pays for building it.
+extern const IKTableC<LEG_LUT_X_STEPS, LEG_LUT_Y_STEPS, 2> legPosLUTStatic;
+
+#endif // IK_HAVE_CONSTEXPR
+
+#endif // _LEG_LUT_STATIC_H_
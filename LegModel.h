@@ -0,0 +1,128 @@
+/*
+ *     LegModel.h
+ *
+ *     This file describes the simple two-joint parallel linkage leg.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LEG_MODEL_H_
+#define _LEG_MODEL_H_
+
+#include "IKChain.h"
+#include "IKFastTrig.h"
+#include "IKSolve.h"
+#include "VectorLib/Vector.h"
+#include "IKSimd.h"
+
+#include <cmath>
+
+// Leg parameters (constexpr so the compile-time table in LegLUTStatic.h can
+// use them)
+constexpr float radii[2] = {30, 30};
+constexpr float offsets[2] = {-2.747, -24.96};
+
+// Upper joint: +25.54deg to -62.51deg
+// Lower joint: -62.51deg to +58.35deg
+constexpr float ranges[2][2] = {{-60.0f/180.0f*PI, 25.0f/180.0f*PI},{-55.0f/180.0f*PI, 55.0f/180.0f*PI}};
+
+// The same leg in fixed point: lengths in 0.01mm, binary angles
+const int_fast32_t i_radii[2] = {3000, 3000};
+const int_fast32_t i_offsets[2] = {-275, -2496};
+const int_fast32_t i_ranges[2][2] = {{-60*TrigLUTTwoPi/360, 25*TrigLUTTwoPi/360},{-55*TrigLUTTwoPi/360, 55*TrigLUTTwoPi/360}};
+
+// Grid of the leg's lookup table (LegLUT.c, LegLUTStatic.h), which tester and
+// bench also solve over
+#define LEG_LUT_X_LOWER (-15.0f)
+#define LEG_LUT_X_UPPER (55.0f)
+#define LEG_LUT_Y_LOWER (-85.0f)
+#define LEG_LUT_Y_UPPER (-25.0f)
+#define LEG_LUT_X_STEP (2.0f)
+#define LEG_LUT_Y_STEP (2.0f)
+#define LEG_LUT_X_STEPS ((int)((LEG_LUT_X_UPPER - LEG_LUT_X_LOWER)/LEG_LUT_X_STEP))
+#define LEG_LUT_Y_STEPS ((int)((LEG_LUT_Y_UPPER - LEG_LUT_Y_LOWER)/LEG_LUT_Y_STEP))
+
+// Function for computing the end effector position from the angles of the
+// joints, with sine and cosine at precision P. Both ranges are well inside
+// IK_FAST_TRIG_DOMAIN, so with IK_PRECISION_APPROX the position is within
+// (radii[0]+radii[1])*IK_FAST_SIN_ERROR of the exact one. With
+// IK_PRECISION_CONSTEXPR the compiler can evaluate it (see LegLUTStatic.h).
+template<IKPrecision P>
+IK_CONSTEXPR14 void legForward(const float * angles, float& x, float& y)
+{
+    float s0 = 0.0f, c0 = 0.0f, s1 = 0.0f, c1 = 0.0f;
+    ikSinCos<P>(angles[0], s0, c0);
+    ikSinCos<P>(angles[1], s1, c1);
+    x = (radii[0]*c0)+(radii[1]*s1)+offsets[0];
+    y = (radii[0]*s0)-(radii[1]*c1)+offsets[1];
+}
+
+template<IKPrecision P>
+inline Vector2d legForwardSolve(const float * angles)
+{
+    Vector2d ret;
+    legForward<P>(angles, ret.x, ret.y);
+    return ret;
+}
+
+inline Vector2d forwardSolve(float * angles)
+{
+    return legForwardSolve<IK_PRECISION_FLOAT>(angles);
+}
+
+// The same leg as an IKChain: the lower link hangs a quarter turn behind its
+// joint angle, and both links are driven directly
+const float phases[2] = {0.0f, -PI/2};
+
+inline IKChain<2> legChain()
+{
+    return IKChain<2>(radii, phases, Vector2d(offsets[0], offsets[1]));
+}
+
+// Fixed-point version of forwardSolve()
+inline void i_forwardSolve(int_fast32_t * angles, vector_int_2d_t& ret)
+{
+    ret.x = ((i_radii[0]*cosLUT(angles[0]) + i_radii[1]*sinLUT(angles[1]) + (TrigLUTMagnitude+1)/2) >> 15) + i_offsets[0];
+    ret.y = ((i_radii[0]*sinLUT(angles[0]) - i_radii[1]*cosLUT(angles[1]) + (TrigLUTMagnitude+1)/2) >> 15) + i_offsets[1];
+}
+
+// Derivative of forwardSolve() by each joint angle
+inline void legJacobian(const float * angles, float J[2][2])
+{
+    J[0][0] = -radii[0]*std::sin(angles[0]);
+    J[1][0] = radii[0]*std::cos(angles[0]);
+    J[0][1] = radii[1]*std::cos(angles[1]);
+    J[1][1] = radii[1]*std::sin(angles[1]);
+}
+
+// Same as legForwardSolve(), for IK_SIMD_WIDTH sets of angles at once
+template<IKPrecision P>
+inline void legForwardSolveV(const IKFloatV * angles, IKFloatV& x, IKFloatV& y)
+{
+    IKFloatV s0, c0, s1, c1;
+    ikSinCos<P>(angles[0], s0, c0);
+    ikSinCos<P>(angles[1], s1, c1);
+    x = ikSet1(radii[0])*c0 + ikSet1(radii[1])*s1 + ikSet1(offsets[0]);
+    y = ikSet1(radii[0])*s0 - ikSet1(radii[1])*c1 + ikSet1(offsets[1]);
+}
+
+inline void forwardSolveV(const IKFloatV * angles, IKFloatV& x, IKFloatV& y)
+{
+    legForwardSolveV<IK_PRECISION_FLOAT>(angles, x, y);
+}
+
+#endif // _LEG_MODEL_H_
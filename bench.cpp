@@ -0,0 +1,335 @@
+/*
+ *     bench.cpp
+ *
+ *     This file benchmarks the IK solvers on the two-joint parallel linkage
+ *     leg, and writes the results as JSON and CSV for tracking regressions.
+ *
+ *     Copyright (C) 2013-2014  Kevin Balke
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License along
+ *     with this program; if not, write to the Free Software Foundation, Inc.,
+ *     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "IKMultiStart.h"
+#include "IKSolve.h"
+#include "LegModel.h"
+#include "VectorLib/Vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Targets per randomly generated set
+#define RANDOM_TARGETS 500
+
+enum BenchEngine
+{
+    BENCH_DESCENT,
+    BENCH_DLS,
+    BENCH_DLS_ANALYTIC,
+    BENCH_FIXED,
+    BENCH_ADAPTIVE,
+    BENCH_DEADLINE,
+    BENCH_CHAIN,
+    BENCH_WORKSPACE,
+    BENCH_APPROX,
+    BENCH_MULTI_START,
+    BENCH_ENGINES
+};
+
+const char * engineNames[BENCH_ENGINES] = {"descent", "dls", "dls_analytic", "fixed", "descent_adaptive", "descent_p50_budget", "descent_chain", "descent_workspace", "descent_approx", "multi_start"};
+
+const float tolerances[] = {0.25f, 0.5f, 1.0f, 2.0f};
+
+struct TargetSet
+{
+    string name;
+    vector<Vector2d> targets;
+};
+
+struct BenchResult
+{
+    string set;
+    string engine;
+    float reqError;
+    int solves;
+    int timeouts;
+    double evalsPerSolve;
+    double nsMean, nsP50, nsP99, nsMax;
+};
+
+float randomRange(float lo, float hi)
+{
+    return lo + (hi-lo)*(rand()/(float)RAND_MAX);
+}
+
+TargetSet gridTargets()
+{
+    TargetSet set;
+    set.name = "grid";
+    for(float y = LEG_LUT_Y_LOWER; y < LEG_LUT_Y_UPPER; y += LEG_LUT_Y_STEP)
+    {
+        for(float x = LEG_LUT_X_LOWER; x < LEG_LUT_X_UPPER; x += LEG_LUT_X_STEP)
+        {
+            set.targets.push_back(Vector2d(x, y));
+        }
+    }
+    return set;
+}
+
+// Forward kinematics of random poses inside the joint limits
+TargetSet reachableTargets()
+{
+    TargetSet set;
+    set.name = "reachable";
+    for(int k = 0; k < RANDOM_TARGETS; k++)
+    {
+        float a[2] = {randomRange(ranges[0][0], ranges[0][1]), randomRange(ranges[1][0], ranges[1][1])};
+        set.targets.push_back(forwardSolve(a));
+    }
+    return set;
+}
+
+// Poses with one joint pinned at a limit
+TargetSet edgeTargets()
+{
+    TargetSet set;
+    set.name = "edge";
+    for(int k = 0; k < RANDOM_TARGETS; k++)
+    {
+        int pinned = k % 2;
+        float a[2] = {randomRange(ranges[0][0], ranges[0][1]), randomRange(ranges[1][0], ranges[1][1])};
+        a[pinned] = ranges[pinned][(k/2) % 2];
+        set.targets.push_back(forwardSolve(a));
+    }
+    return set;
+}
+
+// Points further from the hip than both links together can reach
+TargetSet unreachableTargets()
+{
+    TargetSet set;
+    set.name = "unreachable";
+    for(int k = 0; k < RANDOM_TARGETS; k++)
+    {
+        float phase = randomRange(-PI, PI);
+        float dist = randomRange(1.05f, 1.5f)*(radii[0]+radii[1]);
+        set.targets.push_back(Vector2d(offsets[0]+dist*cos(phase), offsets[1]+dist*sin(phase)));
+    }
+    return set;
+}
+
+// Built once, on first use
+const IKWorkspace& legWorkspace()
+{
+    static IKWorkspace workspace;
+    if(!workspace.built())
+    {
+        workspace.build<2>(ranges, forwardSolve);
+    }
+    return workspace;
+}
+
+// perTarget, when given, receives each target's solve() result. BENCH_DEADLINE
+// gives every solve budgetNs; runBench() for BENCH_DESCENT on the same set
+// and tolerance should come first, so its p50 can be used as the budget.
+BenchResult runBench(const TargetSet& set, BenchEngine engine, float reqError, vector<int>* perTarget = 0, double budgetNs = 0.0)
+{
+    BenchResult res;
+    res.set = set.name;
+    res.engine = engineNames[engine];
+    res.reqError = reqError;
+    res.solves = (int)set.targets.size();
+    res.timeouts = 0;
+
+    long long evals = 0;
+    auto countedSolve = [&evals](float* a){ evals++; return forwardSolve(a); };
+    auto countedApproxSolve = [&evals](float* a){ evals++; return legForwardSolve<IK_PRECISION_APPROX>(a); };
+    auto countedFixedSolve = [&evals](int_fast32_t* a, vector_int_2d_t& ret){ evals++; i_forwardSolve(a, ret); };
+    auto jacobian = [](const float* a, float J[2][2]){ legJacobian(a, J); };
+    IKSolveOptions adaptive;
+    adaptive.adaptiveLerp = true;
+    adaptive.bestEffort = true;
+    IKChain<2> leg = legChain();
+    IKEvaluationCounter chainEvals;
+    IKSolveOptions mapped;
+    mapped.workspace = &legWorkspace();
+    IKSolveOptions deadline;
+    deadline.bestEffort = true;
+    // Multi-start runs share the counter across threads; every run's
+    // evaluations count, including those of runs cancelled by the winner
+    static IKThreadPool pool;
+    atomic<long long> multiEvals(0);
+    auto sharedCountedSolve = [&multiEvals](float* a){ multiEvals.fetch_add(1, memory_order_relaxed); return forwardSolve(a); };
+
+    vector<double> ns;
+    ns.reserve(set.targets.size());
+    for(size_t k = 0; k < set.targets.size(); k++)
+    {
+        const Vector2d& target = set.targets[k];
+        float angles[2] = {0.0f, 0.0f};
+        int_fast32_t i_angles[2] = {0, 0};
+        vector_int_2d_t i_target = {(int_fast32_t)lround(target.x*100), (int_fast32_t)lround(target.y*100)};
+        int solve_res;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        switch(engine)
+        {
+        case BENCH_DESCENT:
+            solve_res = solve<2>(angles, ranges, radii, countedSolve, target, reqError);
+            break;
+        case BENCH_DLS:
+            solve_res = solve<2>(angles, ranges, radii, countedSolve, target, reqError, IK_ENGINE_DLS);
+            break;
+        case BENCH_DLS_ANALYTIC:
+            solve_res = solveDLS<2>(angles, ranges, countedSolve, jacobian, target, reqError);
+            break;
+        case BENCH_ADAPTIVE:
+            solve_res = solve<2>(angles, ranges, radii, countedSolve, target, reqError, adaptive);
+            break;
+        case BENCH_DEADLINE:
+            solve_res = solve<2>(angles, ranges, radii, countedSolve, target, reqError, withTimeBudget(deadline, chrono::nanoseconds((long long)budgetNs)));
+            break;
+        case BENCH_CHAIN:
+            // One more for the start position, as the counting lambdas see it
+            solve_res = solveImplStats<2>(angles, ranges, radii, 2, leg, target, reqError, IKSolveOptions(), chainEvals);
+            evals += 1;
+            break;
+        case BENCH_WORKSPACE:
+            solve_res = solve<2>(angles, ranges, radii, countedSolve, target, reqError, mapped);
+            break;
+        case BENCH_APPROX:
+            solve_res = solve<2>(angles, ranges, radii, countedApproxSolve, target, reqError);
+            break;
+        case BENCH_MULTI_START:
+            solve_res = solveMultiStart<2>(pool, angles, ranges, radii, sharedCountedSolve, target, reqError);
+            break;
+        case BENCH_FIXED:
+            solve_res = solve<2>(i_angles, i_ranges, i_radii, countedFixedSolve, i_target, (int_fast32_t)lround(reqError*100));
+            break;
+        default:
+            solve_res = -1;
+            break;
+        }
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+        ns.push_back((double)chrono::duration_cast<chrono::nanoseconds>(end-start).count());
+        if(solve_res == -1)
+        {
+            res.timeouts++;
+        }
+        if(perTarget)
+        {
+            perTarget->push_back(solve_res);
+        }
+    }
+
+    evals += chainEvals.evaluations + multiEvals.load();
+    sort(ns.begin(), ns.end());
+    double total = 0;
+    for(size_t k = 0; k < ns.size(); k++)
+    {
+        total += ns[k];
+    }
+    res.evalsPerSolve = (double)evals/res.solves;
+    res.nsMean = total/ns.size();
+    res.nsP50 = ns[ns.size()/2];
+    res.nsP99 = ns[min(ns.size()-1, (ns.size()*99)/100)];
+    res.nsMax = ns.back();
+    return res;
+}
+
+int main(int argc, char ** argv)
+{
+    // Output files are <prefix>.json, <prefix>.csv and <prefix>_map.csv
+    string prefix = (argc > 1) ? argv[1] : "bench";
+    srand(1);
+
+    vector<TargetSet> sets;
+    sets.push_back(gridTargets());
+    sets.push_back(reachableTargets());
+    sets.push_back(edgeTargets());
+    sets.push_back(unreachableTargets());
+
+    // Convergence map of the grid: one row per cell and engine, at the
+    // tolerance tester.cpp uses
+    ofstream map((prefix + "_map.csv").c_str());
+    map << "x,y,engine,result" << endl;
+    double descentP50 = 0.0;
+    for(int e = 0; e < BENCH_ENGINES; e++)
+    {
+        vector<int> perTarget;
+        BenchResult res = runBench(sets[0], (BenchEngine)e, 1.0f, &perTarget, descentP50);
+        descentP50 = (e == BENCH_DESCENT) ? res.nsP50 : descentP50;
+        for(size_t k = 0; k < perTarget.size(); k++)
+        {
+            map << sets[0].targets[k].x << "," << sets[0].targets[k].y << "," << engineNames[e] << "," << perTarget[k] << endl;
+        }
+    }
+    map.close();
+
+    vector<BenchResult> results;
+    for(size_t s = 0; s < sets.size(); s++)
+    {
+        for(size_t t = 0; t < sizeof(tolerances)/sizeof(tolerances[0]); t++)
+        {
+            double descentP50 = 0.0;
+            for(int e = 0; e < BENCH_ENGINES; e++)
+            {
+                BenchResult res = runBench(sets[s], (BenchEngine)e, tolerances[t], 0, descentP50);
+                descentP50 = (e == BENCH_DESCENT) ? res.nsP50 : descentP50;
+                cout << res.set << "\t" << res.engine << "\treqError=" << res.reqError
+                     << "\tns p50/p99/max=" << (long long)res.nsP50 << "/" << (long long)res.nsP99 << "/" << (long long)res.nsMax
+                     << "\tevals=" << res.evalsPerSolve
+                     << "\ttimeouts=" << res.timeouts << "/" << res.solves << endl;
+                results.push_back(res);
+            }
+        }
+    }
+
+    ofstream csv((prefix + ".csv").c_str());
+    csv << "set,engine,req_error,solves,timeouts,timeout_rate,evals_per_solve,ns_mean,ns_p50,ns_p99,ns_max" << endl;
+    for(size_t k = 0; k < results.size(); k++)
+    {
+        const BenchResult& r = results[k];
+        csv << r.set << "," << r.engine << "," << r.reqError << "," << r.solves << "," << r.timeouts << ","
+            << (double)r.timeouts/r.solves << "," << r.evalsPerSolve << "," << r.nsMean << ","
+            << r.nsP50 << "," << r.nsP99 << "," << r.nsMax << endl;
+    }
+    csv.close();
+
+    ofstream json((prefix + ".json").c_str());
+    json << "{" << endl << "  \"simd_width\": " << IK_SIMD_WIDTH << "," << endl << "  \"results\": [" << endl;
+    for(size_t k = 0; k < results.size(); k++)
+    {
+        const BenchResult& r = results[k];
+        json << "    {\"set\": \"" << r.set << "\", \"engine\": \"" << r.engine << "\", \"req_error\": " << r.reqError
+             << ", \"solves\": " << r.solves << ", \"timeouts\": " << r.timeouts
+             << ", \"timeout_rate\": " << (double)r.timeouts/r.solves << ", \"evals_per_solve\": " << r.evalsPerSolve
+             << ", \"ns_mean\": " << r.nsMean << ", \"ns_p50\": " << r.nsP50 << ", \"ns_p99\": " << r.nsP99
+             << ", \"ns_max\": " << r.nsMax << "}" << ((k + 1 < results.size()) ? "," : "") << endl;
+    }
+    json << "  ]" << endl << "}" << endl;
+    json.close();
+
+    return 0;
+}
@@ -23,22 +23,37 @@
 
 
 #include "IKSolve.h"
+#include "IKSolveBatch.h"
+#include "IKLut.h"
+#include "IKLutFile.h"
+#include "IKLutGen.h"
+#include "IKLegScheduler.h"
+#include "IKLutMap.h"
+#include "IKMultiStart.h"
+#include "IKQuadLut.h"
+#include "IKTracker.h"
+#include "IKTrajectory.h"
+#include "LegLUTStatic.h"
+#include "LegModel.h"
 #include "VectorLib/Vector.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <fstream>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
 
 using namespace std;
 
 // Forward declarations
-Vector2d forwardSolve(float * angles);
 Vector2d targPos(10,-40);
 
-//void i_forwardSolve(int_fast32_t * angles, vector_int_2d_t& ret);
-//vector_int_2d_t i_targPos = {1000, -500};
-
 float * IK_LUT;
 
 //#define X_LOWER_BOUND -15.0f
@@ -48,87 +63,151 @@ float * IK_LUT;
 //#define X_STEP 1.0f
 //#define Y_STEP 1.0f
 
-#define X_LOWER_BOUND (-15.0f)
-#define X_UPPER_BOUND (55.0f)
-#define Y_LOWER_BOUND (-85.0f)
-#define Y_UPPER_BOUND (-25.0f)
-#define X_STEP (2.0f)
-#define Y_STEP (2.0f)
+#define X_LOWER_BOUND LEG_LUT_X_LOWER
+#define X_UPPER_BOUND LEG_LUT_X_UPPER
+#define Y_LOWER_BOUND LEG_LUT_Y_LOWER
+#define Y_UPPER_BOUND LEG_LUT_Y_UPPER
+#define X_STEP LEG_LUT_X_STEP
+#define Y_STEP LEG_LUT_Y_STEP
 
-#define X_STEPS (int)(abs((X_UPPER_BOUND-X_LOWER_BOUND)/X_STEP))
-#define Y_STEPS (int)(abs((Y_UPPER_BOUND-Y_LOWER_BOUND)/Y_STEP))
+#define X_STEPS LEG_LUT_X_STEPS
+#define Y_STEPS LEG_LUT_Y_STEPS
 
-// Leg parameters
-float angles[2] = {0};
-const float radii[2] = {30, 30};
-const float offsets[2] = {-2.747, -24.96};
+// Directory the generated files are written to (first argument)
+string outDir = "out";
 
-// Upper joint: +25.54deg to -62.51deg
-// Lower joint: -62.51deg to +58.35deg
-const float ranges[2][2] = {{-60.0f/180.0f*PI, 25.0f/180.0f*PI},{-55.0f/180.0f*PI, 55.0f/180.0f*PI}};
+string outPath(const char * name)
+{
+    return outDir + "/" + name;
+}
 
-//int_fast32_t i_radii[2] = {1000, 1000};
-//int_fast32_t i_angles[2] = {0};
+// Every failed check is reported, and makes tester exit non-zero
+int failures = 0;
 
-const float PROGRESS_STEP = 0.05f;
+void check(bool ok, const char * what)
+{
+    if(!ok)
+    {
+        cout << "FAILED: " << what << endl;
+        failures++;
+    }
+}
+
+// Queries a table the way a controller would, at random points between
+// cells. Returns the largest error of the poses it got back.
+template<class LUT>
+float queryTable(const char * name, LUT& lut)
+{
+    int lutHits = 0, lutFallbacks = 0, lutMisses = 0;
+    float lutMaxError = 0.0f;
+    const int LUT_QUERIES = 1000;
+    srand(1);
+    for(int q = 0; q < LUT_QUERIES; q++)
+    {
+        Vector2d target(X_LOWER_BOUND + (X_UPPER_BOUND-X_LOWER_BOUND)*rand()/(float)RAND_MAX,
+                        Y_LOWER_BOUND + (Y_UPPER_BOUND-Y_LOWER_BOUND)*rand()/(float)RAND_MAX);
+        float lutAngles[2];
+        int res = lut.lookup(target, lutAngles);
+        if(res == -1)
+        {
+            lutMisses++;
+            continue;
+        }
+        (res == 0) ? lutHits++ : lutFallbacks++;
+        float err = (forwardSolve(lutAngles)-target).magnitude();
+        lutMaxError = (err > lutMaxError) ? err : lutMaxError;
+    }
+    cout << name << ": " << lutHits << " interpolated, " << lutFallbacks << " solved, "
+         << lutMisses << " unreachable, max error " << lutMaxError << endl;
+    return lutMaxError;
+}
 
-int main()
+int main(int argc, char ** argv)
 {
+    outDir = (argc > 1) ? argv[1] : "out";
+    mkdir(outDir.c_str(), 0755);
+
     // Solve the angles
-    cout<<"Lookup table generation progress: ";
+    cout<<"Lookup table generation: ";
 
     IK_LUT = new float[X_STEPS*Y_STEPS*2];
+    int * solve_res = new int[X_STEPS*Y_STEPS];
 
     cout << X_STEPS << " " << Y_STEPS << endl;
 
-    int solve_res;
-    float prev_progress = 0.0f;
-    float progress = 0.0f;
+    IKThreadPool pool;
+    const IKGrid grid = {X_LOWER_BOUND, Y_LOWER_BOUND, X_STEP, Y_STEP, X_STEPS, Y_STEPS};
+    chrono::steady_clock::time_point genStart = chrono::steady_clock::now();
+    generateLUT<2>(pool, grid, ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f, IK_LUT, solve_res);
+    chrono::steady_clock::time_point genEnd = chrono::steady_clock::now();
 
+    // The table in whole degrees, as LegLUT.c and the files hold it
+    int16_t * lutDegrees = new int16_t[X_STEPS*Y_STEPS*2];
     for(int j = 0; j < Y_STEPS; j++)
     {
         for(int i = 0; i < X_STEPS; i++)
         {
-            //printf("The angles for E.E. position <%f, %f> ", X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP));
-            solve_res = solve(angles, ranges, radii, 2, forwardSolve, Vector2d(X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP)), 1.0f);
-            if(solve_res != -1)
-            {
-                cout<<solve_res<<"\t";
-                //printf("are (%f, %f)\r\n", RAD2DEG(angles[0]), RAD2DEG(angles[1]));
-                IK_LUT[j*X_STEPS+i] = angles[0];
-                IK_LUT[j*X_STEPS+i+1] = angles[1];
-            }
-            else
+            const int k = j*X_STEPS+i;
+            if(solve_res[k] != -1)
             {
-                //printf("cannot be computed.");
-                IK_LUT[j*X_STEPS+i] = 2.215f;
-                IK_LUT[j*X_STEPS+i+1] = 2.215f;
-            }
-            progress = (((float)(j*X_STEPS+i))/((float)(Y_STEPS*X_STEPS)));
-            if(progress > (prev_progress+PROGRESS_STEP))
-            {
-                cout<<(int)(progress*100)<<"%"<<endl;
-                prev_progress = progress;
+                cout<<solve_res[k]<<"\t";
             }
+            lutDegrees[k*2] = (solve_res[k] == -1) ? LUT_UNREACHABLE : lutQuantize(IK_LUT[k*2], 180/PI);
+            lutDegrees[k*2+1] = (solve_res[k] == -1) ? LUT_UNREACHABLE : lutQuantize(IK_LUT[k*2+1], 180/PI);
+        }
+    }
+    cout << endl << "Generated on " << pool.size() << " threads in "
+         << chrono::duration_cast<chrono::microseconds>(genEnd-genStart).count() << "us" << endl;
 
+    // Map the workspace, and generate again without solving for the cells it
+    // rules out; the table must come out the same
+    IKWorkspace workspace;
+    chrono::steady_clock::time_point wsStart = chrono::steady_clock::now();
+    workspace.build<2>(ranges, [](float* a){ return forwardSolve(a); });
+    chrono::steady_clock::time_point wsEnd = chrono::steady_clock::now();
+    float * wsTable = new float[X_STEPS*Y_STEPS*2];
+    int * wsRes = new int[X_STEPS*Y_STEPS];
+    chrono::steady_clock::time_point wsGenStart = chrono::steady_clock::now();
+    generateLUT<2>(pool, grid, ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f, wsTable, wsRes, &workspace);
+    chrono::steady_clock::time_point wsGenEnd = chrono::steady_clock::now();
+    int wsRejected = 0, wsDiffer = 0;
+    for(int k = 0; k < X_STEPS*Y_STEPS; k++)
+    {
+        if(!workspace.reachable(Vector2d(X_LOWER_BOUND+((k % X_STEPS)*X_STEP), Y_LOWER_BOUND+((k / X_STEPS)*Y_STEP)), 1.0f))
+        {
+            wsRejected++;
+        }
+        if(wsRes[k] != solve_res[k] || (wsRes[k] != -1 && (wsTable[k*2] != IK_LUT[k*2] || wsTable[k*2+1] != IK_LUT[k*2+1])))
+        {
+            wsDiffer++;
         }
     }
+    cout << "Workspace map built in " << chrono::duration_cast<chrono::microseconds>(wsEnd-wsStart).count() << "us, rules out "
+         << wsRejected << "/" << X_STEPS*Y_STEPS << " cells; generated in "
+         << chrono::duration_cast<chrono::microseconds>(wsGenEnd-wsGenStart).count() << "us with it, "
+         << wsDiffer << " cells differ" << endl;
+    check(wsDiffer == 0, "generating with the workspace map changes the table");
+    delete[] wsTable;
+    delete[] wsRes;
+    delete[] solve_res;
+
     ofstream LUTFile;
-    LUTFile.open("LegLUT.h");
+    LUTFile.open(outPath("LegLUT.h").c_str());
     LUTFile << "#ifndef _LEG_LUT_H_"<<endl
     <<"#define _LEG_LUT_H_"<<endl
+    <<"#include <stdint.h>"<<endl
     <<"extern const int16_t legPosLUT ["<<Y_STEPS<<"]["<<X_STEPS<<"]["<<2<<"];"<<endl
     <<"#endif"<<endl;
     LUTFile.close();
-    LUTFile.open("LegLUT.c");
+    LUTFile.open(outPath("LegLUT.c").c_str());
 
-    LUTFile<<"#include \"LegLUT.h\""<<endl<<"const int16_t legPosLUT ["<<2<<"]["<<X_STEPS<<"]["<<Y_STEPS<<"] = {"<<endl;
+    LUTFile<<"#include \"LegLUT.h\""<<endl<<"const int16_t legPosLUT ["<<Y_STEPS<<"]["<<X_STEPS<<"]["<<2<<"] = {"<<endl;
     for(int j = 0; j < Y_STEPS; j++)
     {
         LUTFile<<"{";
         for(int i = 0; i < X_STEPS; i++)
         {
-            LUTFile<<"{"<<(int16_t)(IK_LUT[j*X_STEPS+i]*180/PI)<<", "<<(int16_t)(IK_LUT[j*X_STEPS+i+1]*180/PI)<<"}";
+            LUTFile<<"{"<<lutDegrees[(j*X_STEPS+i)*2]<<", "<<lutDegrees[(j*X_STEPS+i)*2+1]<<"}";
             if(i != X_STEPS-1)
             {
                 LUTFile<<", ";
@@ -145,14 +224,14 @@ int main()
 
     LUTFile.close();
 
-    LUTFile.open("graph.txt");
+    LUTFile.open(outPath("graph.txt").c_str());
 
     for(int j = Y_STEPS-1; j >= 0; j--)
     {
         for(int i = 0; i < X_STEPS; i++)
         {
-            if(((int16_t)(IK_LUT[j*X_STEPS+i]*180/PI) == 126) ||
-            ((int16_t)(IK_LUT[j*X_STEPS+i+1]*180/PI) == 126))
+            if((lutDegrees[(j*X_STEPS+i)*2] == LUT_UNREACHABLE) ||
+            (lutDegrees[(j*X_STEPS+i)*2+1] == LUT_UNREACHABLE))
             {
                 LUTFile<<"  ";
             }else
@@ -165,30 +244,602 @@ int main()
 
     LUTFile.close();
 
-    delete IK_LUT;
+#ifdef IK_HAVE_CONSTEXPR
+    // Check the table the compiler built against the float solver it mirrors
+    int staticSolved = 0, staticDiffer = 0;
+    float staticMaxError = 0.0f;
+    for(int j = 0; j < LEG_LUT_Y_STEPS; j++)
+    {
+        for(int i = 0; i < LEG_LUT_X_STEPS; i++)
+        {
+            const int16_t * cell = legPosLUTStatic.data[j][i];
+            Vector2d target(LEG_LUT_X_LOWER+(i*LEG_LUT_X_STEP), LEG_LUT_Y_LOWER+(j*LEG_LUT_Y_STEP));
+            float dls[2] = {0.0f, 0.0f};
+            int res = solve<2>(dls, ranges, radii, [](float* a){ return forwardSolve(a); }, target, 1.0f, IK_ENGINE_DLS);
+            if((res == -1) != (cell[0] == LUT_UNREACHABLE))
+            {
+                staticDiffer++;
+                continue;
+            }
+            if(res == -1)
+            {
+                continue;
+            }
+            staticSolved++;
+            if(abs(cell[0] - lutQuantize(dls[0], 180/PI)) > 1 || abs(cell[1] - lutQuantize(dls[1], 180/PI)) > 1)
+            {
+                staticDiffer++;
+            }
+            float staticAngles[2] = {cell[0]*PI/180, cell[1]*PI/180};
+            float err = (forwardSolve(staticAngles)-target).magnitude();
+            staticMaxError = (err > staticMaxError) ? err : staticMaxError;
+        }
+    }
+    cout << "Compile-time table: " << staticSolved << "/" << LEG_LUT_X_STEPS*LEG_LUT_Y_STEPS << " solved, " << staticDiffer
+         << " cells differ from solve() by more than 1 degree, max error " << staticMaxError << endl;
+    check(staticDiffer == 0, "the compile-time table differs from solve()");
+#endif
 
-    // Solve using integers
-    //cout << "Solve using integer arithmetic:" << endl;
-    //cout << solve(i_angles, i_radii, 2, i_forwardSolve, i_targPos, 100) << endl;
+    // Stream the same table to disk a chunk at a time. Running this again
+    // with the file in place finds every chunk complete and solves nothing.
+    uint64_t geometryHash = lutGeometryHash(radii, 2);
+    geometryHash = lutGeometryHash(offsets, 2, geometryHash);
+    geometryHash = lutGeometryHash(&ranges[0][0], 4, geometryHash);
+    chrono::steady_clock::time_point fileStart = chrono::steady_clock::now();
+    const string binPath = outPath("LegLUT.bin");
+    bool fileOk = generateLutFile<2>(binPath.c_str(), pool, grid, ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f, LUT_INT16, geometryHash);
+    chrono::steady_clock::time_point fileEnd = chrono::steady_clock::now();
 
-    //cout << i_angles[0] << ", " << i_angles[1] << endl;
-    //vector_int_2d_t i_result;
-    //i_forwardSolve(i_angles, i_result);
-    //cout << '<' << i_result.x << ", " << i_result.y << ">" << endl;
-    return 0;
-}
+    // Read it back and check it against the table above
+    int fileMismatches = 0;
+    FILE* binFile = fopen(binPath.c_str(), "rb");
+    IKLutFileHeader binHeader;
+    fileOk = fileOk && binFile && readLutFileHeader(binFile, binHeader) && binHeader.geometryHash == geometryHash && binHeader.sentinel == LUT_UNREACHABLE;
+    int16_t * chunkValues = new int16_t[LUT_FILE_ROWS_PER_CHUNK*X_STEPS*2];
+    for(uint32_t c = 0; fileOk && c < lutChunkCount(binHeader); c++)
+    {
+        fileOk = readLutChunk(binFile, binHeader, c, chunkValues);
+        for(int k = 0; fileOk && k < lutChunkRows(binHeader, c)*X_STEPS*2; k++)
+        {
+            if(chunkValues[k] != lutDegrees[c*LUT_FILE_ROWS_PER_CHUNK*X_STEPS*2 + k])
+            {
+                fileMismatches++;
+            }
+        }
+    }
+    delete[] chunkValues;
+    if(binFile)
+    {
+        fclose(binFile);
+    }
+    cout << "Streamed LegLUT.bin in " << chrono::duration_cast<chrono::microseconds>(fileEnd-fileStart).count() << "us: "
+         << (fileOk ? "ok" : "FAILED") << ", " << fileMismatches << " cells differ from the in-memory table" << endl;
+    check(fileOk && fileMismatches == 0, "LegLUT.bin does not read back as the in-memory table");
 
-// Function for computing the end effector position from the angles of the joints
-Vector2d forwardSolve(float * angles)
-{
-    Vector2d ret;
-    ret.x = (radii[0]*cos(angles[0]))+(radii[1]*sin(angles[1]))+offsets[0];
-    ret.y = (radii[0]*sin(angles[0]))-(radii[1]*cos(angles[1]))+offsets[1];
-    return ret;
-}
+    // Query the in-memory table
+    auto lut = makeLut<2>(lutDegrees, grid, ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f);
+    check(queryTable("Table queries", lut) <= 1.0f, "table queries are off by more than reqError");
+
+    // Build an adaptive table over the same area, refined until interpolation
+    // is within 0.25mm, and compare it with the uniform one
+    auto quad = makeQuadLut<2>(ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f);
+    chrono::steady_clock::time_point quadStart = chrono::steady_clock::now();
+    const int QUAD_DEPTH = 7;
+    int quadSolves = quad.build(Vector2d(X_LOWER_BOUND, Y_LOWER_BOUND), Vector2d(X_UPPER_BOUND, Y_UPPER_BOUND), 0.25f, QUAD_DEPTH, &workspace);
+    chrono::steady_clock::time_point quadEnd = chrono::steady_clock::now();
+    const string quadPath = outPath("LegLUT.quad");
+    const bool quadSaved = quad.save(quadPath.c_str(), geometryHash) && quad.load(quadPath.c_str(), geometryHash);
+    cout << "Quadtree: " << quad.nodeCount() << " nodes, " << quad.leafCount() << " leaves, " << quad.bytes() << " bytes (float grid at the finest level: "
+         << ((1 << QUAD_DEPTH) + 1)*((1 << QUAD_DEPTH) + 1)*2*sizeof(float) << "), " << quadSolves << " solves in "
+         << chrono::duration_cast<chrono::microseconds>(quadEnd-quadStart).count() << "us, save/load " << (quadSaved ? "ok" : "FAILED") << endl;
+    check(quadSaved, "the quadtree does not save and load");
+    // A tree built with the descent engine must still use it once loaded
+    auto descentQuad = makeQuadLut<2>(ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f);
+    auto loadedQuad = makeQuadLut<2>(ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f);
+    const string descentQuadPath = outPath("LegLUT_descent.quad");
+    descentQuad.build(Vector2d(X_LOWER_BOUND, Y_LOWER_BOUND), Vector2d(X_UPPER_BOUND, Y_UPPER_BOUND), 0.25f, QUAD_LUT_MIN_DEPTH, &workspace, IK_ENGINE_DESCENT);
+    check(descentQuad.save(descentQuadPath.c_str(), geometryHash) && loadedQuad.load(descentQuadPath.c_str(), geometryHash) &&
+          loadedQuad.engine() == IK_ENGINE_DESCENT, "a loaded quadtree forgets its engine");
+    check(queryTable("Quadtree queries", quad) <= 1.0f, "quadtree queries are off by more than reqError");
+
+    // Query the streamed table through a shared read-only mapping, then drop
+    // a new copy in place and pick it up without restarting
+    IKLutMap lutMap;
+    const string mapPath = outPath("LegLUT.map");
+    if(packLutFile(binPath.c_str(), mapPath.c_str()) && lutMap.open(mapPath.c_str(), 2, geometryHash))
+    {
+        IKLutMap wrongJoints;
+        check(lutMap.nJoints() == 2 && !wrongJoints.open(mapPath.c_str(), 1, geometryHash), "a table mapped with the wrong joint count");
+        auto mappedLut = makeLut<2>(lutMap.data(), lutMap.grid(), ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f, lutMap.scale(), lutMap.sentinel());
+        check(queryTable("Mapped table queries", mappedLut) <= 1.0f, "mapped table queries are off by more than reqError");
+
+        const bool swapped = writeLutMap(mapPath.c_str(), lutMap.header(), lutMap.data()) && lutMap.refresh();
+        if(swapped)
+        {
+            mappedLut.setTable(lutMap.data(), lutMap.grid(), lutMap.scale());
+        }
+        cout << "Hot swap " << (swapped ? "picked up the new file" : "FAILED") << endl;
+        check(swapped, "the hot swap was not picked up");
+    }
+    else
+    {
+        check(false, "could not map LegLUT.map");
+    }
+
+    delete[] IK_LUT;
+    delete[] lutDegrees;
+
+    // Compare the solver engines over the grid, cold starting every cell
+    const char * engineNames[4] = {"descent", "descent (cached chain)", "DLS (finite difference)", "DLS (analytic)"};
+    int engineSolved[4];
+    IKChain<2> leg = legChain();
+    for(int e = 0; e < 4; e++)
+    {
+        int solved = 0;
+        long long evals = 0;
+        chrono::steady_clock::time_point engineStart = chrono::steady_clock::now();
+        for(int j = 0; j < Y_STEPS; j++)
+        {
+            for(int i = 0; i < X_STEPS; i++)
+            {
+                float cold[2] = {0.0f, 0.0f};
+                Vector2d target(X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP));
+                int res;
+                if(e == 0)
+                {
+                    res = solve<2>(cold, ranges, radii, [](float* a){ return forwardSolve(a); }, target, 1.0f, IK_ENGINE_DESCENT);
+                }
+                else if(e == 1)
+                {
+                    res = solve<2>(cold, ranges, radii, leg, target, 1.0f, IK_ENGINE_DESCENT);
+                }
+                else if(e == 2)
+                {
+                    res = solve<2>(cold, ranges, radii, [](float* a){ return forwardSolve(a); }, target, 1.0f, IK_ENGINE_DLS);
+                }
+                else
+                {
+                    res = solveDLS<2>(cold, ranges, [](float* a){ return forwardSolve(a); }, legJacobian, target, 1.0f);
+                }
+                if(res != -1)
+                {
+                    solved++;
+                    evals += res;
+                }
+            }
+        }
+        chrono::steady_clock::time_point engineEnd = chrono::steady_clock::now();
+        cout << "Engine " << engineNames[e] << ": " << solved << "/" << X_STEPS*Y_STEPS << " solved, "
+             << (solved ? (float)evals/solved : 0.0f) << " evaluations per solve, "
+             << chrono::duration_cast<chrono::microseconds>(engineEnd-engineStart).count() << "us" << endl;
+        engineSolved[e] = solved;
+    }
+    check(engineSolved[1] == engineSolved[0], "the cached chain solves a different set of cells");
+    check(engineSolved[2] >= engineSolved[0] && engineSolved[3] >= engineSolved[0], "DLS solves fewer cells than the descent");
 
-//void i_forwardSolve(int_fast32_t * angles, vector_int_2d_t& ret)
-//{
-//    ret.x = i_radii[0]*cosLUT(angles[0])+i_radii[1]*sinLUT(angles[1]);
-//    ret.y = -i_radii[0]*sinLUT(angles[0])-i_radii[1]*cosLUT(angles[1]);
-//}
+    // Multi-start against solve()'s single cold start, walking the grid with
+    // the last solution as the current pose, and again on a single thread,
+    // where it must not add to the tail latency. The tail is checked in
+    // forward solves per target, which bound the time without its noise.
+    const char * startNames[4] = {"single start", "multi-start (first)", "multi-start (closest)", "multi-start (one thread)"};
+    int startSolved[4];
+    long long startP99Evals[4];
+    IKThreadPool singleThread(1);
+    atomic<long long> startEvals(0);
+    auto countedLeg = [&startEvals](float* a){ startEvals.fetch_add(1, memory_order_relaxed); return forwardSolve(a); };
+    for(int m = 0; m < 4; m++)
+    {
+        int solved = 0;
+        float current[2] = {0.0f, 0.0f};
+        vector<long long> latencies, evaluations;
+        for(int j = 0; j < Y_STEPS; j++)
+        {
+            for(int i = 0; i < X_STEPS; i++)
+            {
+                float pose[2] = {current[0], current[1]};
+                Vector2d target(X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP));
+                chrono::steady_clock::time_point startStart = chrono::steady_clock::now();
+                const long long evalsBefore = startEvals.load();
+                int res;
+                if(m == 0)
+                {
+                    pose[0] = pose[1] = 0.0f;
+                    res = solve<2>(pose, ranges, radii, countedLeg, target, 1.0f);
+                }
+                else
+                {
+                    res = solveMultiStart<2>((m == 3) ? singleThread : pool, pose, ranges, radii, countedLeg, target, 1.0f, (m == 2) ? IK_PREFER_CLOSEST : IK_PREFER_FIRST);
+                }
+                latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now()-startStart).count());
+                evaluations.push_back(startEvals.load() - evalsBefore);
+                if(res != -1)
+                {
+                    solved++;
+                    current[0] = pose[0];
+                    current[1] = pose[1];
+                }
+            }
+        }
+        sort(latencies.begin(), latencies.end());
+        sort(evaluations.begin(), evaluations.end());
+        startSolved[m] = solved;
+        startP99Evals[m] = evaluations[(evaluations.size()*99)/100];
+        cout << "Solve " << startNames[m] << ": " << solved << "/" << X_STEPS*Y_STEPS << " solved, p50/p99/max "
+             << latencies[latencies.size()/2]/1000 << "/" << latencies[(latencies.size()*99)/100]/1000 << "/" << latencies.back()/1000
+             << "us, p99 " << startP99Evals[m] << " evaluations" << endl;
+    }
+    check(startSolved[1] >= startSolved[0] && startSolved[2] >= startSolved[0], "multi-start solves fewer cells than a single start");
+    check(startP99Evals[3] <= startP99Evals[0], "multi-start on one thread has a longer tail than a single start");
+
+    // From the zero pose, the first two seeds are the same one
+    float seeds[IK_MULTI_START_SEEDS][2];
+    const float zeroPose[2] = {0.0f, 0.0f};
+    const int nSeeds = multiStartSeeds<2>(zeroPose, ranges, seeds);
+    bool seedsInRange = true;
+    for(int s = 0; s < nSeeds; s++)
+    {
+        for(int j = 0; j < 2; j++)
+        {
+            seedsInRange = seedsInRange && seeds[s][j] >= ranges[j][0] && seeds[s][j] <= ranges[j][1];
+        }
+    }
+    check(nSeeds == IK_MULTI_START_SEEDS - 1, "multi-start repeats a seed");
+    check(seedsInRange, "multi-start seeds outside the joint ranges");
+
+    // Polynomial sine and cosine: kernel error over the joint ranges, then
+    // the descent with them, checking every solution against the exact
+    // forward kinematics
+    double sinError = 0.0, cosError = 0.0;
+    for(int j = 0; j < 2; j++)
+    {
+        for(int k = 0; k <= 100000; k++)
+        {
+            float a = ranges[j][0] + (ranges[j][1]-ranges[j][0])*(k/100000.0f);
+            double se = fabs(ikFastSin(a) - sin((double)a)), ce = fabs(ikFastCos(a) - cos((double)a));
+            sinError = (se > sinError) ? se : sinError;
+            cosError = (ce > cosError) ? ce : cosError;
+        }
+    }
+    int approxSolved = 0, approxMissed = 0;
+    float approxMaxError = 0.0f;
+    chrono::steady_clock::time_point approxStart = chrono::steady_clock::now();
+    for(int j = 0; j < Y_STEPS; j++)
+    {
+        for(int i = 0; i < X_STEPS; i++)
+        {
+            float approx[2] = {0.0f, 0.0f};
+            Vector2d target(X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP));
+            if(solve<2>(approx, ranges, radii, [](float* a){ return legForwardSolve<IK_PRECISION_APPROX>(a); }, target, 1.0f) == -1)
+            {
+                continue;
+            }
+            approxSolved++;
+            float err = (forwardSolve(approx)-target).magnitude();
+            approxMaxError = (err > approxMaxError) ? err : approxMaxError;
+            approxMissed += (err > 1.0f) ? 1 : 0;
+        }
+    }
+    chrono::steady_clock::time_point approxEnd = chrono::steady_clock::now();
+    cout << "Approximate trig: sin/cos error " << sinError << "/" << cosError << " over the ranges, descent "
+         << approxSolved << "/" << X_STEPS*Y_STEPS << " solved in " << chrono::duration_cast<chrono::microseconds>(approxEnd-approxStart).count()
+         << "us, max exact error " << approxMaxError << ", " << approxMissed << " over reqError" << endl;
+    check(sinError <= IK_FAST_SIN_ERROR && cosError <= IK_FAST_COS_ERROR, "the polynomial sin/cos exceed their documented error");
+    check(approxMissed == 0, "solutions with the polynomial sin/cos miss reqError");
+
+    // The incremental update of a longer serial chain must agree with a full
+    // forward solve
+    const float armLengths[6] = {20, 18, 15, 12, 8, 5};
+    const float armPhases[6] = {0, 0, 0, 0, 0, 0};
+    IKChain<6> arm(armLengths, armPhases, Vector2d(0, 0), IK_CHAIN_SERIAL);
+    float armAngles[6];
+    float chainError = 0.0f;
+    srand(1);
+    for(int k = 0; k < 6; k++)
+    {
+        armAngles[k] = -1.0f + 2.0f*rand()/(float)RAND_MAX;
+    }
+    arm.setAngles(armAngles);
+    for(int q = 0; q < 1000; q++)
+    {
+        const int joint = rand() % 6;
+        armAngles[joint] += -0.1f + 0.2f*rand()/(float)RAND_MAX;
+        const float trialError = (arm.trial(joint, armAngles[joint]) - arm(armAngles)).magnitude();
+        arm.commit(joint, armAngles[joint]);
+        const float cachedError = (arm.position() - arm(armAngles)).magnitude();
+        chainError = (trialError > chainError) ? trialError : chainError;
+        chainError = (cachedError > chainError) ? cachedError : chainError;
+    }
+    cout << "Serial chain: max incremental error " << chainError << " after 1000 single joint steps" << endl;
+    check(chainError < 1e-3f, "the serial chain's incremental updates drift");
+
+    // Adaptive best effort solves with the joint count fixed at run time
+    // must match the compile time ones
+    IKSolveOptions adaptiveBest;
+    adaptiveBest.adaptiveLerp = true;
+    adaptiveBest.bestEffort = true;
+    int runtimeDiffer = 0;
+    for(int q = 0; q < 100; q++)
+    {
+        Vector2d target(X_LOWER_BOUND + (X_UPPER_BOUND-X_LOWER_BOUND)*rand()/(float)RAND_MAX,
+                        Y_LOWER_BOUND + (Y_UPPER_BOUND-Y_LOWER_BOUND)*rand()/(float)RAND_MAX);
+        float fixedPose[2] = {0.0f, 0.0f}, runtimePose[2] = {0.0f, 0.0f};
+        IKNoStats noStats;
+        auto fk = [](float* a){ return forwardSolve(a); };
+        const int fixedRes = solveImplStats<2>(fixedPose, ranges, radii, 2, fk, target, 1.0f, adaptiveBest, noStats);
+        const int runtimeRes = solveImplStats<0>(runtimePose, ranges, radii, 2, fk, target, 1.0f, adaptiveBest, noStats);
+        runtimeDiffer += (fixedRes != runtimeRes || fixedPose[0] != runtimePose[0] || fixedPose[1] != runtimePose[1]) ? 1 : 0;
+    }
+    check(runtimeDiffer == 0, "runtime sized adaptive solves differ from compile time sized ones");
+
+    // Find out why the cold solves that fail stop where they do
+    IKStatsHistogram histogram;
+    IKSolveStats stats;
+    stats.hook = IKStatsHistogram::record;
+    stats.hookData = &histogram;
+    for(int j = 0; j < Y_STEPS; j++)
+    {
+        for(int i = 0; i < X_STEPS; i++)
+        {
+            float cold[2] = {0.0f, 0.0f};
+            solveStats<2>(cold, ranges, radii, [](float* a){ return forwardSolve(a); }, Vector2d(X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP)), 1.0f, stats);
+        }
+    }
+    cout << "Stop reasons: " << histogram.reasons[IK_STOP_CONVERGED] << " converged, "
+         << histogram.reasons[IK_STOP_TIMEOUT] << " timeout, "
+         << histogram.reasons[IK_STOP_JOINT_LIMIT] << " joint limit, "
+         << histogram.reasons[IK_STOP_OSCILLATING] << " oscillating" << endl;
+    cout << "Evaluations per lerp phase:";
+    for(int p = 0; p < STATS_LERP_PHASES; p++)
+    {
+        cout << " " << histogram.phaseEvaluations[p];
+    }
+    cout << endl;
+
+    // Solve the grid using integers and compare against the float solver
+    int fixedSolved = 0, floatSolved = 0;
+    long long fixedEvals = 0;
+    float fixedMaxError = 0.0f, fixedMaxDeviation = 0.0f;
+    chrono::steady_clock::time_point fixedStart = chrono::steady_clock::now();
+    for(int j = 0; j < Y_STEPS; j++)
+    {
+        for(int i = 0; i < X_STEPS; i++)
+        {
+            Vector2d target(X_LOWER_BOUND+(i*X_STEP), Y_LOWER_BOUND+(j*Y_STEP));
+            vector_int_2d_t i_target = {(int_fast32_t)lround(target.x*100), (int_fast32_t)lround(target.y*100)};
+            int_fast32_t i_angles[2] = {0, 0};
+            int_fast32_t i_res = solve<2>(i_angles, i_ranges, i_radii, i_forwardSolve, i_target, 100);
+            float f_angles[2] = {0.0f, 0.0f};
+            int f_res = solve<2>(f_angles, ranges, radii, [](float* a){ return forwardSolve(a); }, target, 1.0f);
+            floatSolved += (f_res != -1) ? 1 : 0;
+            if(i_res == -1)
+            {
+                continue;
+            }
+            fixedSolved++;
+            fixedEvals += i_res;
+            float asFloat[2] = {i_angles[0]*2.0f*PI/TrigLUTTwoPi, i_angles[1]*2.0f*PI/TrigLUTTwoPi};
+            Vector2d reached = forwardSolve(asFloat);
+            float err = (reached-target).magnitude();
+            fixedMaxError = (err > fixedMaxError) ? err : fixedMaxError;
+            if(f_res != -1)
+            {
+                float dev = (reached-forwardSolve(f_angles)).magnitude();
+                fixedMaxDeviation = (dev > fixedMaxDeviation) ? dev : fixedMaxDeviation;
+            }
+        }
+    }
+    chrono::steady_clock::time_point fixedEnd = chrono::steady_clock::now();
+    cout << "Fixed point: " << fixedSolved << "/" << X_STEPS*Y_STEPS << " solved (float: " << floatSolved << "), "
+         << (fixedSolved ? (float)fixedEvals/fixedSolved : 0.0f) << " evaluations per solve, max error " << fixedMaxError
+         << ", max deviation from float " << fixedMaxDeviation << " (both solvers "
+         << chrono::duration_cast<chrono::microseconds>(fixedEnd-fixedStart).count() << "us)" << endl;
+    // The fixed-point solver measures error on its own sine table, so allow
+    // a little over reqError when checking with the float model
+    check(fixedMaxError <= 1.1f, "fixed-point solutions miss reqError");
+
+    // Solve the same grid again with the batched solver, starting every
+    // target from the zero pose
+    const int gridSize = X_STEPS*Y_STEPS;
+    float * batchX = new float[gridSize];
+    float * batchY = new float[gridSize];
+    float * batchAngles[2] = {new float[gridSize], new float[gridSize]};
+    int * batchRes = new int[gridSize];
+    for(int j = 0; j < Y_STEPS; j++)
+    {
+        for(int i = 0; i < X_STEPS; i++)
+        {
+            batchX[j*X_STEPS+i] = X_LOWER_BOUND+(i*X_STEP);
+            batchY[j*X_STEPS+i] = Y_LOWER_BOUND+(j*Y_STEP);
+            batchAngles[0][j*X_STEPS+i] = 0.0f;
+            batchAngles[1][j*X_STEPS+i] = 0.0f;
+        }
+    }
+    chrono::steady_clock::time_point batchStart = chrono::steady_clock::now();
+    solveBatch<2>(batchAngles, ranges, radii, forwardSolveV, batchX, batchY, gridSize, 1.0f, batchRes);
+    chrono::steady_clock::time_point batchEnd = chrono::steady_clock::now();
+    int batchSolved = 0;
+    for(int k = 0; k < gridSize; k++)
+    {
+        if(batchRes[k] != -1)
+        {
+            batchSolved++;
+        }
+    }
+    cout << "Batch solve (" << IK_SIMD_WIDTH << " lanes): " << batchSolved << "/" << gridSize << " solved in "
+         << chrono::duration_cast<chrono::microseconds>(batchEnd-batchStart).count() << "us" << endl;
+    check(batchSolved == engineSolved[0], "the batch solver solves a different number of cells than solve()");
+
+    // Again, letting the workspace map turn unreachable targets away
+    int * wsBatchRes = new int[gridSize];
+    for(int k = 0; k < gridSize; k++)
+    {
+        batchAngles[0][k] = 0.0f;
+        batchAngles[1][k] = 0.0f;
+    }
+    batchStart = chrono::steady_clock::now();
+    solveBatch<2>(batchAngles, ranges, radii, forwardSolveV, batchX, batchY, gridSize, 1.0f, wsBatchRes, &workspace);
+    batchEnd = chrono::steady_clock::now();
+    int wsBatchDiffer = 0;
+    for(int k = 0; k < gridSize; k++)
+    {
+        if(wsBatchRes[k] != batchRes[k])
+        {
+            wsBatchDiffer++;
+        }
+    }
+    cout << "Batch solve with workspace map: " << chrono::duration_cast<chrono::microseconds>(batchEnd-batchStart).count()
+         << "us, " << wsBatchDiffer << " results differ" << endl;
+    check(wsBatchDiffer == 0, "the workspace map changes batch results");
+
+    // And with the polynomial sine and cosine, which stay in registers
+    int * approxBatchRes = new int[gridSize];
+    for(int k = 0; k < gridSize; k++)
+    {
+        batchAngles[0][k] = 0.0f;
+        batchAngles[1][k] = 0.0f;
+    }
+    batchStart = chrono::steady_clock::now();
+    solveBatch<2>(batchAngles, ranges, radii, legForwardSolveV<IK_PRECISION_APPROX>, batchX, batchY, gridSize, 1.0f, approxBatchRes);
+    batchEnd = chrono::steady_clock::now();
+    int approxBatchSolved = 0;
+    float approxBatchError = 0.0f;
+    for(int k = 0; k < gridSize; k++)
+    {
+        if(approxBatchRes[k] == -1)
+        {
+            continue;
+        }
+        approxBatchSolved++;
+        float approx[2] = {batchAngles[0][k], batchAngles[1][k]};
+        float err = (forwardSolve(approx)-Vector2d(batchX[k], batchY[k])).magnitude();
+        approxBatchError = (err > approxBatchError) ? err : approxBatchError;
+    }
+    cout << "Batch solve with approximate trig: " << approxBatchSolved << "/" << gridSize << " solved in "
+         << chrono::duration_cast<chrono::microseconds>(batchEnd-batchStart).count() << "us, max exact error " << approxBatchError << endl;
+    check(approxBatchError <= 1.0f, "batch solutions with the polynomial sin/cos miss reqError");
+    delete[] approxBatchRes;
+    delete[] wsBatchRes;
+    delete[] batchX;
+    delete[] batchY;
+    delete[] batchAngles[0];
+    delete[] batchAngles[1];
+    delete[] batchRes;
+
+    // Follow a target moving around a circle, about 1mm per tick
+    auto tracker = makeTracker<2>(ranges, radii, [](float* a){ return forwardSolve(a); }, 1.0f);
+    float seed[2] = {0.0f, 0.0f};
+    solve<2>(seed, ranges, radii, [](float* a){ return forwardSolve(a); }, Vector2d(30.0f, -55.0f), 1.0f);
+    tracker.reset(seed);
+    int trackConverged = 0, trackMaxEvals = 0, trackTotalEvals = 0;
+    const int TRACK_TICKS = 1000;
+    for(int t = 0; t < TRACK_TICKS; t++)
+    {
+        float phase = 2.0f*PI*t/(float)TRACK_TICKS*16.0f;
+        IKTrackResult track = tracker.update(Vector2d(20.0f+10.0f*cos(phase), -55.0f+10.0f*sin(phase)));
+        trackConverged += track.converged ? 1 : 0;
+        trackTotalEvals += track.evaluations;
+        trackMaxEvals = (track.evaluations > trackMaxEvals) ? track.evaluations : trackMaxEvals;
+    }
+    cout << "Tracking: " << trackConverged << "/" << TRACK_TICKS << " ticks converged, "
+         << (float)trackTotalEvals/TRACK_TICKS << " evaluations per tick, " << trackMaxEvals << " max" << endl;
+    check(trackMaxEvals <= IK_TRACK_MAX_EVALS, "a tracking update overran its evaluation budget");
+
+    // Eight gait cycles (stance stroke back, swing forward through the air)
+    // sampled every 1mm, solved as one trajectory with a 10rad/s joint
+    // velocity limit at 100 points per second, then again in parallel
+    // segments
+    const Vector2d gaitCycle[4] = {Vector2d(35.0f, -65.0f), Vector2d(5.0f, -65.0f), Vector2d(10.0f, -55.0f), Vector2d(30.0f, -55.0f)};
+    vector<Vector2d> gaitWaypoints;
+    for(int c = 0; c < 8; c++)
+    {
+        gaitWaypoints.insert(gaitWaypoints.end(), gaitCycle, gaitCycle + 4);
+    }
+    gaitWaypoints.push_back(gaitCycle[0]);
+    vector<Vector2d> gait;
+    samplePath(&gaitWaypoints[0], (int)gaitWaypoints.size(), 1.0f, gait);
+    const float maxVelocity[2] = {10.0f, 10.0f};
+    IKTrajectoryLimits limits;
+    limits.maxVelocity = maxVelocity;
+    limits.dt = 0.01f;
+    const int gaitPoints = (int)gait.size();
+    for(int p = 0; p < 2; p++)
+    {
+        vector<float> gaitAngles(gaitPoints*2);
+        vector<IKTrajectoryStatus> gaitStatus(gaitPoints);
+        chrono::steady_clock::time_point gaitStart = chrono::steady_clock::now();
+        int gaitSolved = solveTrajectory<2>(&gait[0], gaitPoints, 0, ranges, radii, leg, 1.0f, limits, &gaitAngles[0], &gaitStatus[0], p ? &pool : 0);
+        chrono::steady_clock::time_point gaitEnd = chrono::steady_clock::now();
+        int gaitLimited = 0, gaitUnreached = 0;
+        float gaitMaxStep = 0.0f, gaitMaxError = 0.0f, gaitMaxJump = 0.0f;
+        for(int k = 0; k < gaitPoints; k++)
+        {
+            gaitLimited += (gaitStatus[k] == IK_TRAJECTORY_LIMITED) ? 1 : 0;
+            gaitUnreached += (gaitStatus[k] == IK_TRAJECTORY_UNREACHED) ? 1 : 0;
+            float jump = 0.0f;
+            for(int j = 0; k > 0 && j < 2; j++)
+            {
+                float step = fabs(gaitAngles[k*2+j] - gaitAngles[(k-1)*2+j]);
+                gaitMaxStep = (step > gaitMaxStep) ? step : gaitMaxStep;
+                jump += step*step;
+            }
+            gaitMaxJump = (sqrt(jump) > gaitMaxJump) ? sqrt(jump) : gaitMaxJump;
+            if(gaitStatus[k] == IK_TRAJECTORY_OK)
+            {
+                float err = (forwardSolve(&gaitAngles[k*2])-gait[k]).magnitude();
+                gaitMaxError = (err > gaitMaxError) ? err : gaitMaxError;
+            }
+        }
+        cout << "Trajectory (" << (p ? "parallel segments" : "sequential") << "): " << gaitSolved << "/" << gaitPoints << " solved, "
+             << gaitLimited << " velocity limited, " << gaitUnreached << " unreached, max joint step " << gaitMaxStep
+             << ", max error " << gaitMaxError << ", " << chrono::duration_cast<chrono::microseconds>(gaitEnd-gaitStart).count() << "us" << endl;
+        check(gaitMaxStep <= maxVelocity[0]*limits.dt + 1e-5f, "a trajectory step exceeds the velocity limit");
+        check(gaitMaxError <= 1.0f, "trajectory points marked solved miss reqError");
+        check(gaitMaxJump <= limits.maxJump + 1e-5f, "a trajectory step exceeds maxJump");
+    }
+
+    // A jump between the two ends of the workspace is refused rather than
+    // taken in one step, and a path with no spacing has no points
+    const Vector2d jumpPath[2] = {Vector2d(35.0f, -65.0f), Vector2d(-5.0f, -40.0f)};
+    float jumpAngles[4];
+    IKTrajectoryStatus jumpStatus[2];
+    IKTrajectoryLimits tightJump;
+    tightJump.maxJump = 0.05f;
+    solveTrajectory<2>(jumpPath, 2, 0, ranges, radii, leg, 1.0f, tightJump, jumpAngles, jumpStatus);
+    const float jumpDistance = sqrt((jumpAngles[2]-jumpAngles[0])*(jumpAngles[2]-jumpAngles[0]) + (jumpAngles[3]-jumpAngles[1])*(jumpAngles[3]-jumpAngles[1]));
+    check(jumpStatus[0] == IK_TRAJECTORY_OK && jumpStatus[1] == IK_TRAJECTORY_UNREACHED && jumpDistance <= tightJump.maxJump + 1e-5f, "a trajectory jumped further than maxJump");
+    vector<Vector2d> noSpacing;
+    samplePath(jumpPath, 2, 0.0f, noSpacing);
+    check(noSpacing.empty(), "samplePath() with no spacing returned points");
+
+    // Six legs walking the same circle half a cycle apart in pairs, with a
+    // 1ms deadline per tick
+    const int LEGS = 6;
+    IKLegScheduler<2, IKChain<2> > legs(LEGS, ranges, radii, legChain(), 1.0f);
+    for(int t = 0; t < TRACK_TICKS; t++)
+    {
+        for(int l = 0; l < LEGS; l++)
+        {
+            float phase = 2.0f*PI*t/(float)TRACK_TICKS*16.0f + ((l % 2) ? PI : 0.0f);
+            legs.setTarget(l, Vector2d(20.0f+10.0f*cos(phase), -55.0f+10.0f*sin(phase)));
+        }
+        legs.tick(chrono::steady_clock::now() + chrono::milliseconds(1));
+        legs.wait();
+    }
+    cout << "Scheduler (" << legs.threads() << " threads):";
+    for(int l = 0; l < LEGS; l++)
+    {
+        IKLegResult<2> res = legs.result(l);
+        cout << " [" << res.ticks << " ticks, mean " << res.totalLatencyNs/(long long)res.ticks/1000 << "us, max "
+             << res.maxLatencyNs/1000 << "us, " << res.deadlineMisses << " missed]";
+        check(res.ticks == (uint64_t)TRACK_TICKS, "a leg missed scheduler ticks");
+    }
+    cout << endl;
+
+    if(failures)
+    {
+        cout << failures << " checks FAILED" << endl;
+        return 1;
+    }
+    cout << "All checks passed" << endl;
+    return 0;
+}